@@ -0,0 +1,70 @@
+;;
+;; bench.scm (benchmark workloads for wart, see bench.md)
+;;
+
+(define bench-iota (lambda (n) (if (= n 0) () (cons n (bench-iota (- n 1))))))
+(define bench-sum (lambda (p) (if (pair? p) (+ (car p) (bench-sum (cdr p))) 0)))
+
+; countdown: one actor sends itself a decremented count
+(define countdown-beh
+  (BEH (n)
+    (if (> n 0) (SEND SELF (list (- n 1))) ())))
+
+; ring: n actors pass a decremented count to the next
+(define ring-link-beh
+  (lambda (next)
+    (BEH (n)
+      (if (> n 0) (SEND next (list (- n 1))) ()))))
+(define ring-first-beh  ; first message closes the ring
+  (BEH (last n)
+    (BECOME (ring-link-beh last))
+    (SEND last (list (- n 1)))))
+(define make-ring
+  (lambda (k next)
+    (if (= k 0) next (make-ring (- k 1) (CREATE (ring-link-beh next))))))
+
+; fork/join: binary tree of depth d, leaves answer 1, joins add
+(define join-beh
+  (lambda (cust)
+    (BEH (a)
+      (BECOME (BEH (b) (SEND cust (list (+ a b))))))))
+(define leaf-beh
+  (BEH (cust _)
+    (SEND cust '(1))))
+(define tree-beh
+  (BEH (cust d)
+    (define join (CREATE (join-beh cust)))
+    (SEND (CREATE (tree-node (- d 1))) (list join (- d 1)))
+    (SEND (CREATE (tree-node (- d 1))) (list join (- d 1)))))
+(define tree-node
+  (lambda (d)
+    (if (= d 0) leaf-beh tree-beh)))
+
+; eval: symbol lookup and procedure application
+(define eval-loop
+  (lambda (k)
+    (if (= k 0) 0 (seq (bench-sum (bench-iota 20)) (eval-loop (- k 1))))))
+
+(define a-countdown
+  (CREATE
+    (BEH _
+      (SEND (CREATE countdown-beh) '(10000)))))
+(define a-ring
+  (CREATE
+    (BEH _
+      (define first (CREATE ring-first-beh))
+      (SEND first (list (make-ring 99 first) 10000)))))
+(define a-fork-join
+  (CREATE
+    (BEH _
+      (SEND (CREATE (tree-node 10)) (list a-sink 10)))))
+
+(bench 'load)
+(a-countdown)
+(bench 'countdown)
+(a-ring)
+(bench 'ring)
+(a-fork-join)
+(bench 'fork_join)
+(eval-loop 200)
+(bench 'eval)
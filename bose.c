@@ -62,43 +62,11 @@ assert_fail(char* _file_, int _line_)
  * console output
  */
 
-static void
-print(u32 unicode) {
-    if ((unicode == '\t')
-    ||  (unicode == '\n')
-    ||  ((unicode >= 0x20) && (unicode < 0x7F))) {
-        putchar(unicode);
-    } else if (unicode >= 0xA0) {
-        putchar('~');  // replacement character
-    }
-}
-
-static void
-prints(char * s) {
-    u32 c;
-
-    while (s && (c = (u32)(*s++))) {
-        print(c);
-    }
-}
-
 static void
 newline() {
     putchar('\n');
 }
 
-static void
-space(int indent) {  // space between values
-    if (indent > 0) {
-        newline();
-        while (--indent > 0) {
-            prints("  ");  // indent 2 spaces
-        }
-    } else {
-        print(' ');
-    }
-}
-
 /*
  * BOSE encode/decode helpers
  */
@@ -289,6 +257,8 @@ encode_utf8(u8* bp, u32 w, int k)
  * decode BOSE values
  */
 
+static void release_value(ACTOR* v);  // FORWARD DECL
+
 static ACTOR*
 decode_number(u8 prefix, ACTOR* it)
 {
@@ -301,6 +271,115 @@ decode_number(u8 prefix, ACTOR* it)
     return v;
 }
 
+/*
+ * A string slice shares octets with another string instead of copying
+ * them. The header is marked with byte_04 = STRING_SLICE, data_08 holds
+ * the octet count, data_0c points to the first octet, and data_10 marks
+ * the end of the block holding it. Later octets follow the usual chain
+ * of extended blocks, so iterators simply start from the given position.
+ * Strings are immutable, but the source must outlive its slices.
+ */
+#define STRING_SLICE        0x53  // header byte_04 marker ('S')
+#define SLICE_MIN           21    // shorter strings are copied (smol size)
+#define string_slice(s)     (((struct cal_value*)(s))->byte_04 == STRING_SLICE)
+
+static void
+skip_octets(struct example_5* x, u32 n)  // advance octet iterator by n
+{
+    u8* p = (u8*)x->data_08;
+    u8* q = (u8*)x->data_0c;
+    x->data_04 -= n;  // update count
+    while (n > 0) {
+        if (p >= q) {  // out of bounds
+            p = (u8*)(*((u32*)q));  //  load next block of data
+            q = p + 0x1c;  // update end
+        }
+        u32 k = q - p;  // octets remaining in block
+        if (k > n) {
+            k = n;
+        }
+        p += k;
+        n -= k;
+    }
+    x->data_08 = (u32)p;  // update start
+    x->data_0c = (u32)q;  // update end
+}
+
+static ACTOR*
+slice_octets(u8 prefix, ACTOR* it, u32 size)  // share next size octets of it
+{
+    struct example_5* x = (struct example_5*)it;
+    if (x->data_04 < size) return NULL;  // fail! -- not enough octets
+    struct cal_value* v = (struct cal_value*)reserve();
+    if (!v) return NULL;  // fail!
+    *((struct example_5*)v) = *((struct example_5*)(&v_string_0));
+    u8* p = (u8*)x->data_08;
+    u8* q = (u8*)x->data_0c;
+    if ((size > 0) && (p >= q)) {  // start in next block
+        p = (u8*)(*((u32*)q));
+        q = p + 0x1c;
+    }
+    v->byte_04 = STRING_SLICE;
+    v->byte_05 = prefix;
+    v->byte_06 = p_int_0;  // extended size format
+    v->byte_07 = n_4;  // size is a 4-byte integer
+    v->data_08 = size;
+    v->data_0c = (u32)p;  // pointer to starting octet
+    v->data_10 = (u32)q;  // pointer to end of block
+    skip_octets(x, size);
+    return (ACTOR*)v;
+}
+
+static ACTOR*
+decode_slice(u8 prefix, int size, ACTOR* it)  // string sharing octets with input
+{
+    struct example_5 scan = *((struct example_5*)it);  // look ahead without consuming
+    if (prefix == utf8) {  // validate encoding before sharing
+#if ASCII_UTF8_TO_OCTETS
+        int ascii = true;
+#endif
+        u32 ch = 0;
+        int k = 0;
+        int n = size;
+        while (n-- > 0) {
+            u32 w = read_code((ACTOR*)(&scan));
+            if (w > 0xFF) return NULL;  // fail! -- not in octet range
+#if ASCII_UTF8_TO_OCTETS
+            if (w > 0x7F) {
+                ascii = false;
+            }
+#endif
+            k = decode_utf8(&ch, (u8)w, k);
+            if (k < 0) return NULL;  // fail!
+        }
+        if (k != 0) return NULL;  // fail! -- incomplete character
+#if ASCII_UTF8_TO_OCTETS
+        if (ascii) {
+            prefix = octets;  // replace utf8 prefix with octets
+        }
+#endif
+    }
+    return slice_octets(prefix, it, size);
+}
+
+ACTOR*
+new_string_slice(ACTOR* s, u32 offset, u32 count)  // share octets [offset, offset+count) of s
+{
+    u8 prefix = value_prefix(s);
+    if (count == 0) return &v_string_0;
+    if (prefix == string_0) return NULL;  // fail! -- out of range
+    ACTOR* it = new_string_iterator(s);
+    if (!it) return NULL;  // fail!
+    struct example_5* x = (struct example_5*)it;
+    ACTOR* v = NULL;  // init to fail
+    if (x->data_04 >= (offset + count)) {
+        skip_octets(x, offset);  // NOTE: utf8 offsets must fall on character boundaries
+        v = slice_octets(prefix, it, count);
+    }
+    release(it);
+    return v;
+}
+
 static ACTOR*
 decode_string(u8 prefix, ACTOR* it)
 {
@@ -320,6 +399,10 @@ decode_string(u8 prefix, ACTOR* it)
         DEBUG(puts("decode_string: unsupported encoding\n"));
         return NULL;  // fail!
     }
+    struct example_5* x = (struct example_5*)it;
+    if ((size >= SLICE_MIN) && (x->data_18 == (u32)decode_octets)) {
+        return decode_slice(prefix, size, it);  // zero-copy
+    }
     ACTOR* sb = new_string_builder(prefix);
     if (!sb) return NULL;  // fail!
 #if ASCII_UTF8_TO_OCTETS
@@ -372,16 +455,20 @@ decode_array(u8 prefix, ACTOR* it)
     if (prefix == array_n) {  // counted array?
         if (!decode_int(&count, in)) return NULL;  // fail!
     }
-    v = new_array();
+    ACTOR* ab = new_array_builder();
+    if (!ab) return NULL;  // fail!
     while (y->data_04 > 0) {
         ACTOR* item = decode_bose(in);
         if (!item) return NULL;  // fail!
-        ACTOR* a = array_insert(v, array_element_count(v), item);
-        if (!v) return NULL;  // fail!
-        release(v);
-        v = a;
+        if (!array_append(ab, item)) return NULL;  // fail!
         --count;
-        // FIXME: check for correct element count?
+    }
+    v = get_array_built(ab);
+    release(ab);
+    if ((prefix == array_n) && (count != 0)) {  // wrong element count
+        release_value(v);
+        release(y);
+        return NULL;  // fail!
     }
     y->data_04 = x->data_04 - size;  // calculate outer size remaining
     *x = *y;  // update outer iterator from inner
@@ -405,18 +492,22 @@ decode_object(u8 prefix, ACTOR* it)
     if (prefix == object_n) {  // counted object?
         if (!decode_int(&count, in)) return NULL;  // fail!
     }
-    v = new_object();
+    ACTOR* ob = new_object_builder();
+    if (!ob) return NULL;  // fail!
     while (y->data_04 > 0) {
         ACTOR* name = decode_bose(in);
         if (!name) return NULL;  // fail!
         ACTOR* value = decode_bose(in);
         if (!value) return NULL;  // fail!
-        ACTOR* o = object_set(v, name, value);
-        if (!v) return NULL;  // fail!
-        release(v);
-        v = o;
+        if (!object_append(ob, name, value)) return NULL;  // fail!
         --count;
-        // FIXME: check for correct property count?
+    }
+    v = get_object_built(ob);
+    release(ob);
+    if ((prefix == object_n) && (count != 0)) {  // wrong property count
+        release_value(v);
+        release(y);
+        return NULL;  // fail!
     }
     y->data_04 = x->data_04 - size;  // calculate outer size remaining
     *x = *y;  // update outer iterator from inner
@@ -486,6 +577,376 @@ decode_bose(ACTOR* it)
     return v;
 }
 
+/*
+ * streaming BOSE decoder
+ *
+ * Octets are pushed in chunks of any size with bose_stream_write().
+ * Open collections are kept on an explicit stack, so decoding resumes
+ * at any octet boundary and nesting depth is bounded. Each complete
+ * top-level value is sent to the customer as (value, BOSE_PATH_NONE).
+ * With BOSE_STREAM_ITEMS, elements of a top-level array are sent as
+ * (value, index) as soon as they complete, followed by (NULL, count).
+ * Malformed input discards any partial value, sends (NULL, BOSE_PATH_FAIL)
+ * and resyncs at the next top-level value.
+ */
+
+extern void send_2(ACTOR* target, u32 msg_1, u32 msg_2);
+
+#define STREAM_DEPTH        12    // maximum collection nesting
+
+enum {  // parser states
+    ST_VALUE,       // expect value prefix
+    ST_INT,         // expect integer prefix (size or count)
+    ST_INT_SIZE,    // expect integer octet count
+    ST_INT_OCTETS,  // integer octets (lsb first)
+    ST_STRING       // string octets
+};
+
+enum {  // use of integer being read
+    K_NUMBER,       // number value
+    K_STRING,       // string size
+    K_COLLECTION,   // array/object size
+    K_COUNT         // element/property count
+};
+
+struct stream_frame {
+    u32         remaining;  // octets left in collection
+    ACTOR*      builder;    // array/object builder (NULL for streamed items)
+    ACTOR*      name;       // pending property name (objects only)
+    int         count;      // elements/properties still expected, or -1 if uncounted
+};
+
+struct bose_stream {
+    ACTOR*      cust;       // customer for decoded values (NULL = keep last)
+    u32         flags;      // BOSE_STREAM_* options
+    u8          state;      // ST_* parser state
+    u8          next;       // K_* use of integer being read
+    u8          prefix;     // prefix of string/collection being read
+    u8          sign;       // sign-extend integer being read
+    int         n;          // integer accumulator
+    u32         shift;      // integer bit position
+    u32         left;       // integer/string octets remaining
+    ACTOR*      sb;         // string builder
+    u32         ch;         // partial character
+    int         k;          // character continuation octets expected
+    u32         index;      // next streamed item index
+    ACTOR*      last;       // most recent top-level value
+    u32         depth;      // number of open collections
+    u8          kind[STREAM_DEPTH];  // collection prefix
+    struct stream_frame frame[STREAM_DEPTH];
+};
+
+#define STREAM_SIZE         256   // reserve_n() block holding bose_stream
+
+ACTOR*
+new_bose_stream(ACTOR* cust, u32 flags)  // allocate a push decoder
+{
+    struct bose_stream* ds = (struct bose_stream*)reserve_n(STREAM_SIZE);
+    if (!ds) return NULL;  // fail!
+    ds->cust = cust;
+    ds->flags = flags;
+    ds->state = ST_VALUE;
+    ds->sb = NULL;
+    ds->index = 0;
+    ds->last = NULL;
+    ds->depth = 0;
+    return (ACTOR*)ds;
+}
+
+static int
+stream_add(struct bose_stream* ds, ACTOR* v)  // add value to innermost collection
+{
+    if (!v) return false;  // fail!
+    if (ds->depth == 0) {  // top-level value
+        ds->last = v;
+        if (ds->cust) {
+            send_2(ds->cust, (u32)v, BOSE_PATH_NONE);
+        }
+        return true;  // success.
+    }
+    struct stream_frame* f = &ds->frame[ds->depth - 1];
+    if (f->count == 0) {  // more items than counted
+        release_value(v);
+        return false;  // fail!
+    }
+    if (!f->builder) {  // streamed array item
+        if (ds->cust) {
+            send_2(ds->cust, (u32)v, ds->index);
+        }
+        ++ds->index;
+    } else if ((ds->kind[ds->depth - 1] & 0xF9) == 0x00) {  // Array type
+        if (!array_append(f->builder, v)) {
+            release_value(v);
+            return false;  // fail!
+        }
+    } else if (!f->name) {  // property name
+        f->name = v;
+        return true;  // success. -- value still expected
+    } else {
+        if (!object_append(f->builder, f->name, v)) {
+            release_value(v);
+            return false;  // fail!
+        }
+        f->name = NULL;
+    }
+    if (f->count > 0) {
+        --f->count;
+    }
+    return true;  // success.
+}
+
+static int
+stream_close(struct bose_stream* ds)  // complete collections with no octets left
+{
+    while (ds->depth > 0) {
+        struct stream_frame* f = &ds->frame[ds->depth - 1];
+        if (f->remaining > 0) return true;  // collection continues
+        if (f->name) return false;  // fail! -- property value missing
+        if (f->count > 0) return false;  // fail! -- fewer items than counted
+        u8 kind = ds->kind[--ds->depth];
+        if (!f->builder) {  // end of streamed items
+            if (ds->cust) {
+                send_2(ds->cust, (u32)NULL, ds->index);
+            }
+            ds->index = 0;
+            continue;
+        }
+        ACTOR* v = ((kind & 0xF9) == 0x00)
+            ? get_array_built(f->builder)
+            : get_object_built(f->builder);
+        release(f->builder);
+        if (!stream_add(ds, v)) return false;  // fail!
+    }
+    return true;  // success.
+}
+
+static int
+stream_emit(struct bose_stream* ds, ACTOR* v)  // deliver completed value
+{
+    ds->state = ST_VALUE;
+    return stream_add(ds, v) && stream_close(ds);
+}
+
+static int
+stream_open(struct bose_stream* ds, int size)  // push new collection
+{
+    if ((size < 0) || (ds->depth >= STREAM_DEPTH)) return false;  // fail!
+    if (ds->depth > 0) {
+        struct stream_frame* p = &ds->frame[ds->depth - 1];
+        if (p->remaining < (u32)size) return false;  // fail! -- overflows parent
+        p->remaining -= size;  // outer octets are consumed by inner collection
+    }
+    struct stream_frame* f = &ds->frame[ds->depth];
+    u8 prefix = ds->prefix;
+    f->remaining = size;
+    f->name = NULL;
+    f->count = -1;  // uncounted, unless a count follows
+    if ((prefix & 0xF9) == 0x00) {  // Array type
+        if ((ds->flags & BOSE_STREAM_ITEMS) && (ds->depth == 0)) {
+            f->builder = NULL;  // stream items to customer
+        } else {
+            f->builder = new_array_builder();
+            if (!f->builder) return false;  // fail!
+        }
+    } else {
+        f->builder = new_object_builder();
+        if (!f->builder) return false;  // fail!
+    }
+    ds->kind[ds->depth++] = prefix;
+    if ((prefix == array_n) || (prefix == object_n)) {  // counted collection?
+        ds->next = K_COUNT;
+        ds->state = ST_INT;
+        return true;  // success.
+    }
+    ds->state = ST_VALUE;
+    return stream_close(ds);  // may be empty
+}
+
+static int
+stream_int(struct bose_stream* ds)  // integer complete
+{
+    int n = ds->n;
+    if (ds->sign && (ds->shift < (sizeof(int) << 3))) {
+        n |= (int)(~0u << ds->shift);  // sign-extend
+    }
+    switch (ds->next) {
+        case K_NUMBER: {
+            return stream_emit(ds, new_int(n));
+        }
+        case K_STRING: {
+            if (n < 0) return false;  // fail!
+            ds->sb = new_string_builder(ds->prefix);
+            if (!ds->sb) return false;  // fail!
+            ds->left = n;
+            ds->ch = 0;
+            ds->k = 0;
+            ds->state = ST_STRING;
+            if (n > 0) return true;  // success.
+            ACTOR* v = get_string_built(ds->sb);
+            release(ds->sb);
+            ds->sb = NULL;
+            return stream_emit(ds, v);
+        }
+        case K_COLLECTION: {
+            return stream_open(ds, n);
+        }
+        default: {  // K_COUNT
+            if (n < 0) return false;  // fail!
+            ds->frame[ds->depth - 1].count = n;
+            ds->state = ST_VALUE;
+            return stream_close(ds);
+        }
+    }
+}
+
+static int
+stream_value(struct bose_stream* ds, u8 b)  // value prefix
+{
+    switch (b) {
+        case null:      return stream_emit(ds, &v_null);
+        case true:      return stream_emit(ds, &v_true);
+        case false:     return stream_emit(ds, &v_false);
+        case n_0:       return stream_emit(ds, &v_number_0);
+        case string_0:  return stream_emit(ds, &v_string_0);
+        case array_0:   return stream_emit(ds, &v_array_0);
+        case object_0:  return stream_emit(ds, &v_object_0);
+    }
+    int n = SMOL2INT(b);
+    if ((n >= SMOL_MIN) && (n <= SMOL_MAX)) {
+        return stream_emit(ds, new_int(n));
+    }
+    ds->prefix = b;
+    if ((b & 0xF8) == 0x08) {  // String type (2#0000_1xxx)
+        if ((b != octets) && (b != utf8)) return false;  // fail! -- unsupported encoding
+        ds->next = K_STRING;
+        ds->state = ST_INT;
+    } else if ((b & 0xF8) == 0x00) {  // Array/Object type (2#0000_0xxx)
+        ds->next = K_COLLECTION;
+        ds->state = ST_INT;
+    } else if ((b & 0xF0) == 0x10) {  // Integer type (2#0001_xxxx)
+        ds->sign = (b & 0x08);
+        ds->next = K_NUMBER;
+        ds->state = ST_INT_SIZE;
+    } else {
+        // FIXME: handle additional number encodings
+        return false;  // fail!
+    }
+    return true;  // success.
+}
+
+static int
+stream_octet(struct bose_stream* ds, u8 b)  // advance decoder by one octet
+{
+    if (ds->depth > 0) {  // charge octet to innermost collection
+        struct stream_frame* f = &ds->frame[ds->depth - 1];
+        if (f->remaining == 0) return false;  // fail! -- collection overflow
+        --f->remaining;
+    }
+    switch (ds->state) {
+        case ST_VALUE: {
+            return stream_value(ds, b);
+        }
+        case ST_INT: {
+            int n = SMOL2INT(b);
+            if ((n >= SMOL_MIN) && (n <= SMOL_MAX)) {
+                ds->n = n;
+                ds->sign = false;
+                ds->shift = (sizeof(int) << 3);
+                return stream_int(ds);
+            }
+            if ((b & 0xF0) != 0x10) return false;  // fail! -- not an integer
+            ds->sign = (b & 0x08);
+            ds->state = ST_INT_SIZE;
+            return true;  // success.
+        }
+        case ST_INT_SIZE: {
+            int n = SMOL2INT(b);
+            if ((n < 0) || (n > sizeof(int))) return false;  // fail! -- too large
+            ds->n = 0;
+            ds->shift = 0;
+            ds->left = n;
+            ds->state = ST_INT_OCTETS;
+            if (n > 0) return true;  // success.
+            return stream_int(ds);
+        }
+        case ST_INT_OCTETS: {
+            ds->n |= ((u32)b << ds->shift);
+            ds->shift += (1 << 3);
+            if (--ds->left > 0) return true;  // success.
+            return stream_int(ds);
+        }
+        case ST_STRING: {
+            if (ds->prefix == utf8) {
+                ds->k = decode_utf8(&ds->ch, b, ds->k);
+                if (ds->k < 0) return false;  // fail!
+            } else {
+                ds->ch = b;
+            }
+            if (ds->k == 0) {  // character complete
+                if (!write_code(ds->sb, ds->ch)) return false;  // fail!
+                ds->ch = 0;
+            }
+            if (--ds->left > 0) return true;  // success.
+            if (ds->k != 0) return false;  // fail! -- incomplete character
+            ACTOR* v = get_string_built(ds->sb);
+            release(ds->sb);
+            ds->sb = NULL;
+            return stream_emit(ds, v);
+        }
+    }
+    return false;  // fail!
+}
+
+static void
+stream_discard(struct bose_stream* ds)  // release partial value, reset parser
+{
+    while (ds->depth > 0) {
+        struct stream_frame* f = &ds->frame[--ds->depth];
+        if (f->builder) {
+            release_value(get_array_built(f->builder));  // partial array/object
+            release(f->builder);
+        }
+        release_value(f->name);
+    }
+    if (ds->sb) {
+        release_value(get_string_built(ds->sb));  // partial string
+        release(ds->sb);
+        ds->sb = NULL;
+    }
+    ds->index = 0;
+    ds->state = ST_VALUE;
+}
+
+static int
+stream_fail(struct bose_stream* ds)  // discard partial value, resync at top level
+{
+    DEBUG(puts("bose_stream: fail!\n"));
+    stream_discard(ds);
+    if (ds->cust) {
+        send_2(ds->cust, (u32)NULL, BOSE_PATH_FAIL);
+    }
+    return false;  // fail!
+}
+
+int
+bose_stream_write(ACTOR* s, u8* data, u32 n)  // push octets into decoder
+{
+    struct bose_stream* ds = (struct bose_stream*)s;
+    while (n-- > 0) {
+        if (!stream_octet(ds, *data++)) return stream_fail(ds);
+    }
+    return true;  // success.
+}
+
+void
+bose_stream_free(ACTOR* s)  // release decoder and any partial value
+{
+    struct bose_stream* ds = (struct bose_stream*)s;
+    if (!ds) return;
+    stream_discard(ds);
+    release_n(s, STREAM_SIZE);
+}
+
 /*
  * encode BOSE values
  */
@@ -534,6 +995,10 @@ encode_string(ACTOR* sb, ACTOR* v)
         TRACE(puts(":int]\n"));
         if (w == 0) return write_code(sb, string_0);  // special case for empty string
         p += 0x0c;  // pointer to starting octet
+        if (string_slice(v)) {
+            q = (u8*)(((struct cal_value*)v)->data_10);  // ending octet (shared block)
+            p = (u8*)(((struct cal_value*)v)->data_0c);  // pointer to shared octet
+        }
     }
     ok = write_code(sb, b)
       && encode_u32(sb, w);
@@ -547,99 +1012,180 @@ encode_string(ACTOR* sb, ACTOR* v)
     return ok;
 }
 
+/*
+ * Collections are encoded in two passes. encode_size() first computes
+ * the exact content size, so the prefix and size can be written before
+ * the elements, which are then encoded directly into the output.
+ * Arrays holding only integers are packed into a local buffer and
+ * written in bulk with write_octets().
+ */
+
 static int
-encode_array(ACTOR* sb, ACTOR* v)
+size_u32(u32 w)  // octets written by encode_u32()
 {
-    int ok = true;
-    u32 w = array_element_count(v);
-    TRACE(puts("encode_array["));
-    TRACE(serial_dec32(w));
-    TRACE(puts("]\n"));
-    if (w == 0) return write_code(sb, array_0);  // special case for empty array
-    // encode array contents
+    if (w <= SMOL_MAX) return 1;
+    if (w <= 0xFFFF) return 4;
+    return 6;
+}
+
+static int
+size_int(int n)  // octets written by encode_int()
+{
+    if (n >= 0) return size_u32(n);
+    if (n >= SMOL_MIN) return 1;
+    return 6;
+}
+
+static int
+pack_int(u8* p, u8 prefix, u32 w)  // encode integer into p, as encode_number() would
+{
+    int n = (int)w;
+    if ((prefix == m_int_0) && (n < 0)) {  // encode_int()
+        if (n >= SMOL_MIN) {
+            *p = INT2SMOL(n);
+            return 1;
+        }
+        p[0] = m_int_0;
+    } else if (w <= SMOL_MAX) {  // encode_u32()
+        *p = INT2SMOL(w);
+        return 1;
+    } else if (w <= 0xFFFF) {
+        p[0] = p_int_0;
+        p[1] = n_2;
+        p[2] = (u8)w;
+        p[3] = (u8)(w >> 8);
+        return 4;
+    } else {
+        p[0] = p_int_0;
+    }
+    p[1] = n_4;
+    p[2] = (u8)w;
+    p[3] = (u8)(w >> 8);
+    p[4] = (u8)(w >> 16);
+    p[5] = (u8)(w >> 24);
+    return 6;
+}
+
+static int
+encode_size(ACTOR* v)  // octets written by encode_bose(), or -1 on failure
+{
+    struct example_5* x = (struct example_5*)v;
+    u8* p = (u8*)v;
+    u8 b = *(p + 0x05);
+    int size = 0;
+
+    if (x->beh_1c != &b_value) return -1;  // fail! -- wrong actor type
+    if ((b == null) || (b == true) || (b == false)) return 1;
+    if ((b & 0xF8) == 0x08) {  // String type (2#0000_1xxx)
+        u32 w = SMOL2INT(*(p + 0x06));  // smol size
+        if (w > 20) {
+            w = *((u32*)(p + 0x08));  // get extended size
+        }
+        if (w == 0) return 1;  // string_0
+        return 1 + size_u32(w) + w;
+    }
+    if ((b & 0xF8) == 0x00) {  // Array/Object type (2#0000_0xxx)
+        if (x->data_08 == 0) return 1;  // array_0/object_0
+        ACTOR* it = new_collection_iterator(v);
+        if (!it) return -1;  // fail!
+        while ((v = read_item(it)) != NULL) {
+            int n = encode_size(v);
+            if (n < 0) {
+                size = -1;  // fail!
+                break;
+            }
+            size += n;
+        }
+        release(it);
+        if (size < 0) return -1;  // fail!
+        return 1 + size_u32(size) + size;
+    }
+    if ((b & ~0x7) == p_int_0) return size_u32(x->data_08);
+    if ((b & ~0x7) == m_int_0) return size_int((int)x->data_08);
+    // FIXME: handle different number formats and bignums...
+    return -1;  // fail!
+}
+
+static int
+encode_int_array(ACTOR* sb, ACTOR* v)  // bulk encode array of integers
+{
+    u8 buf[64];
+    int n = 0;
     ACTOR* it = new_collection_iterator(v);
     if (!it) return false;  // fail!
-    ACTOR* content = new_string_builder(octets);
-    if (!content) return false;  // fail!
-    while (w-- > 0) {
-        ACTOR* item = read_item(it);
-        if (!item) return false;  // fail!
-        if (!encode_bose(content, item)) return false;  // fail!
+    while ((v = read_item(it)) != NULL) {
+        if (n > (sizeof(buf) - 6)) {  // flush when next integer may not fit
+            if (!write_octets(sb, buf, n)) {
+                n = -1;  // fail!
+                break;
+            }
+            n = 0;
+        }
+        struct cal_value* x = (struct cal_value*)v;
+        n += pack_int(buf + n, x->byte_05 & ~0x7, x->data_08);
     }
     release(it);
-    ACTOR* s = get_string_built(content);
-    struct example_5* x = (struct example_5*)s;
-    release(content);
-    w = x->data_08;  // get content size
-    TRACE(puts("encode_array: content size = "));
-    TRACE(serial_dec32(w));
-    TRACE(newline());
-    // encode array (w/ known size)
-    ok = write_code(sb, array)
-      && encode_u32(sb, w);
-    it = new_string_iterator((ACTOR*)s);
+    if (n < 0) return false;  // fail!
+    return write_octets(sb, buf, n);
+}
+
+static int
+encode_collection(ACTOR* sb, ACTOR* v, u8 prefix)  // encode array or object
+{
+    int ints = (prefix == array);  // integer-only array?
+    int size = 0;
+    ACTOR* a = NULL;
+    ACTOR* it = new_collection_iterator(v);
     if (!it) return false;  // fail!
-    TRACE(puts("encode_array: content"));
-    while (ok && (w-- > 0)) {
-        u32 ch = read_code(it);
-        if (ch == EOF) return false;  // fail!
-        TRACE(putchar(' '));
-        TRACE(serial_hex8(ch));
-        ok = write_code(sb, ch);
+    while ((a = read_item(it)) != NULL) {  // size pass
+        int n = encode_size(a);
+        if (n < 0) {
+            size = -1;  // fail!
+            break;
+        }
+        size += n;
+        u8 b = value_prefix(a);
+        if (((b & ~0x7) != p_int_0) && ((b & ~0x7) != m_int_0)) {
+            ints = false;
+        }
     }
+    release(it);
+    if (size < 0) return false;  // fail!
+    TRACE(puts("encode_collection: content size = "));
+    TRACE(serial_dec32(size));
     TRACE(newline());
-    release(s);
+    if (!write_code(sb, prefix) || !encode_u32(sb, size)) return false;  // fail!
+    if (ints) return encode_int_array(sb, v);
+    it = new_collection_iterator(v);
+    if (!it) return false;  // fail!
+    int ok = true;
+    while (ok && ((a = read_item(it)) != NULL)) {  // encode pass
+        ok = encode_bose(sb, a);
+    }
     release(it);
     return ok;
 }
 
+static int
+encode_array(ACTOR* sb, ACTOR* v)
+{
+    u32 w = array_element_count(v);
+    TRACE(puts("encode_array["));
+    TRACE(serial_dec32(w));
+    TRACE(puts("]\n"));
+    if (w == 0) return write_code(sb, array_0);  // special case for empty array
+    return encode_collection(sb, v, array);
+}
+
 static int
 encode_object(ACTOR* sb, ACTOR* v)
 {
-    int ok = true;
     u32 w = object_property_count(v);
     TRACE(puts("encode_object["));
     TRACE(serial_dec32(w));
     TRACE(puts("]\n"));
     if (w == 0) return write_code(sb, object_0);  // special case for empty object
-    // encode object contents
-    ACTOR* it = new_collection_iterator(v);
-    if (!it) return false;  // fail!
-    ACTOR* content = new_string_builder(octets);
-    if (!content) return false;  // fail!
-    while (w-- > 0) {
-        ACTOR* name = read_item(it);
-        if (!name) return false;  // fail!
-        if (!encode_bose(content, name)) return false;  // fail!
-        ACTOR* value = read_item(it);
-        if (!value) return false;  // fail!
-        if (!encode_bose(content, value)) return false;  // fail!
-    }
-    release(it);
-    ACTOR* s = get_string_built(content);
-    struct example_5* x = (struct example_5*)s;
-    release(content);
-    w = x->data_08;  // get content size
-    TRACE(puts("encode_object: content size = "));
-    TRACE(serial_dec32(w));
-    TRACE(newline());
-    // encode object (w/ known size)
-    ok = write_code(sb, object)
-      && encode_u32(sb, w);
-    it = new_string_iterator((ACTOR*)s);
-    if (!it) return false;  // fail!
-    TRACE(puts("encode_object: content"));
-    while (ok && (w-- > 0)) {
-        u32 ch = read_code(it);
-        if (ch == EOF) return false;  // fail!
-        TRACE(putchar(' '));
-        TRACE(serial_hex8(ch));
-        ok = write_code(sb, ch);
-    }
-    TRACE(newline());
-    release(s);
-    release(it);
-    return ok;
+    return encode_collection(sb, v, object);
 }
 
 int
@@ -750,6 +1296,8 @@ string_compare(ACTOR* s, ACTOR* t)  // MIN_INT = incomparable
         d = (int)(sc - tc);
         if ((sc == EOF) || (tc == EOF)) break;  // end of string(s)
     }
+    release(si);
+    release(ti);
     return d;
 }
 
@@ -789,6 +1337,10 @@ new_string_iterator(ACTOR* s)
         n = *((int*)(bp + 0x08));  // get extended size
         p = bp + 0x0c;  // pointer to starting octet
         x->data_0c = (u32)(p + 12);  // pointer to ending octet
+        if (string_slice(s)) {
+            p = (u8*)(((struct cal_value*)s)->data_0c);  // pointer to shared octet
+            x->data_0c = ((struct cal_value*)s)->data_10;  // end of shared block
+        }
     }
     x->data_04 = (u32)n;  // total octets remaining
     x->data_08 = (u32)p;  // pointer to starting octet
@@ -858,48 +1410,408 @@ new_string_builder(u8 prefix)
     return (ACTOR*)x;  // success.
 }
 
-int
-write_code(ACTOR* sb, u32 code)
+/*
+ * A buffered sink collects octets in a caller-supplied buffer and hands
+ * them to its flush procedure in bulk, when the buffer fills and on
+ * sink_flush(). Without a flush procedure, output is bounded by the
+ * buffer and stays there. write_code() accepts a sink in place of a
+ * string builder, so JSON conversion and BOSE encoding can target both.
+ */
+
+ACTOR*
+new_buffer_sink(u8* buf, u32 size, octet_flush flush, void* ctx)
+{
+    struct example_5* x = (struct example_5*)reserve();  // new sink
+    if (!x) return NULL;  // fail!
+    x->data_04 = (u32)buf;  // pointer to buffer
+    x->data_08 = 0;  // octets buffered
+    x->data_0c = size;  // buffer size
+    x->data_10 = (u32)flush;  // flush procedure (or NULL)
+    x->data_14 = (u32)ctx;  // flush context
+    x->data_18 = (u32)sink_flush;  // tag for write_code()
+    return (ACTOR*)x;  // success.
+}
+
+int
+sink_flush(ACTOR* sk)  // pass buffered octets to flush procedure
+{
+    struct example_5* x = (struct example_5*)sk;
+    octet_flush flush = (octet_flush)(x->data_10);
+    int n = x->data_08;
+    if (!flush || (n == 0)) return true;  // nothing to do
+    x->data_08 = 0;  // empty buffer
+    return ((*flush)((void*)(x->data_14), (u8*)(x->data_04), n) >= 0);
+}
+
+static int
+sink_octet(struct example_5* x, u32 code)  // add octet to sink buffer
+{
+    if (code > 0xFF) return false;  // fail! -- not an octet
+    if (x->data_08 >= x->data_0c) {  // buffer full
+        if (!x->data_10) return false;  // fail! -- no flush procedure
+        if (!sink_flush((ACTOR*)x)) return false;  // fail!
+    }
+    ((u8*)(x->data_04))[x->data_08++] = (u8)code;
+    return true;  // success.
+}
+
+int
+write_code(ACTOR* sb, u32 code)
+{
+    struct example_5* x = (struct example_5*)sb;
+    if (x->data_18 == (u32)sink_flush) return sink_octet(x, code);
+    struct example_5* s = (struct example_5*)x->data_04;
+    u8* p = (u8*)x->data_08;
+    u8* q = (u8*)x->data_0c;
+    int (*encode)(u8*,u32,int) = (int(*)(u8*,u32,int))(x->data_18);
+    int k = 0;
+    do {
+        if (p >= q) {  // out of space
+            struct example_5* y = (struct example_5*)reserve();
+            if (!y) return false;  // fail!
+            y->beh_1c = (ACTOR*)0;  // NULL next/link pointer
+            p = (u8*)y;  // update start
+            *((u32*)q) = (u32)p;  // link to next block
+            q = (p + 0x1c);
+            x->data_0c = (u32)q;  // update end
+        }
+        k = (*encode)(p, code, k);  // call encode procedure
+        if (k < 0) return false;  // fail!
+        ++(s->data_08);  // update count
+        x->data_08 = (u32)(++p);  // update start
+    } while (k > 0);
+    return true;  // success.
+}
+
+int
+write_octets(ACTOR* sb, const u8* data, u32 n)  // bulk write_code() of octets
+{
+    struct example_5* x = (struct example_5*)sb;
+    if (x->data_18 == (u32)sink_flush) {  // buffered output sink
+        while (n > 0) {
+            if (x->data_08 >= x->data_0c) {  // buffer full
+                if (!x->data_10) return false;  // fail! -- no flush procedure
+                if (!sink_flush(sb)) return false;  // fail!
+            }
+            u8* p = ((u8*)(x->data_04)) + x->data_08;
+            u32 k = x->data_0c - x->data_08;  // space remaining
+            if (k > n) {
+                k = n;
+            }
+            x->data_08 += k;
+            n -= k;
+            while (k-- > 0) {
+                *p++ = *data++;
+            }
+        }
+        return true;  // success.
+    }
+    if (x->data_18 != (u32)encode_octets) {  // character encoding required
+        while (n-- > 0) {
+            if (!write_code(sb, *data++)) return false;  // fail!
+        }
+        return true;  // success.
+    }
+    struct example_5* s = (struct example_5*)x->data_04;
+    u8* p = (u8*)x->data_08;
+    u8* q = (u8*)x->data_0c;
+    while (n > 0) {
+        if (p >= q) {  // out of space
+            struct example_5* y = (struct example_5*)reserve();
+            if (!y) return false;  // fail!
+            y->beh_1c = (ACTOR*)0;  // NULL next/link pointer
+            p = (u8*)y;  // update start
+            *((u32*)q) = (u32)p;  // link to next block
+            q = (p + 0x1c);
+            x->data_0c = (u32)q;  // update end
+        }
+        u32 k = q - p;  // space remaining in block
+        if (k > n) {
+            k = n;
+        }
+        s->data_08 += k;  // update count
+        n -= k;
+        while (k-- > 0) {
+            *p++ = *data++;
+        }
+        x->data_08 = (u32)p;  // update start
+    }
+    return true;  // success.
+}
+
+ACTOR*
+new_array()  // allocate a new (empty) array
+{
+    struct example_5* x = (struct example_5*)reserve();
+    if (!x) return NULL;  // fail!
+    struct example_5* y = (struct example_5*)(&v_array_0);
+    *x = *y;  // copy empty array template
+    return (ACTOR*)x;
+}
+
+/*
+ * Arrays that outgrow their first extended block are kept as a tree.
+ * The header is marked with byte_04 = ARRAY_TREE, data_0c points to the
+ * root node, and data_10 holds the number of node levels above the leaves.
+ * A leaf is a 32-byte block of up to 7 element pointers, with the count
+ * in its last word. A node is a 256-byte block holding its child count,
+ * its element total and up to 62 children. array_insert() copies only
+ * the path from the root to one leaf, so each version shares every other
+ * block with the array it came from. An array builder appends along the
+ * right edge without updating totals there, so the total of a last child
+ * is never read; it is whatever its parent's total leaves over.
+ */
+#define ARRAY_TREE          0x54  // header byte_04 marker ('T')
+#define ARRAY_FLAT_MAX      10    // elements held by header and one extended block
+#define ARRAY_LEAF          7     // element pointers per leaf
+#define ARRAY_FANOUT        62    // children per node
+#define ARRAY_NODE_SIZE     256   // reserve_n() block holding a node
+#define ARRAY_LEVELS        4     // right-edge node levels tracked by a builder
+#define array_tree(a)       (((struct cal_value*)(a))->byte_04 == ARRAY_TREE)
+#define tree_total(c, h)    ((h) ? (c)[1] : (c)[7])  // elements under block c at level h
+
+static u32*
+array_leaf(ACTOR* a, u32* index)  // leaf holding element *index, and offset within it
+{
+    struct cal_value* x = (struct cal_value*)a;
+    u32* n = (u32*)x->data_0c;  // root node
+    u32 h = x->data_10;  // node levels above leaves
+    u32 i = *index;
+    while (h-- > 0) {
+        u32 k = n[0] - 1;  // last child takes the rest
+        u32 j;
+        for (j = 0; j < k; ++j) {
+            u32 t = tree_total((u32*)n[2 + j], h);
+            if (i < t) break;
+            i -= t;
+        }
+        n = (u32*)n[2 + j];
+    }
+    *index = i;
+    return n;
+}
+
+static void
+tree_free(u32* n, u32 h)  // release tree blocks (not elements)
+{
+    if (h == 0) {
+        release(n);
+        return;
+    }
+    u32 j;
+    for (j = 0; j < n[0]; ++j) {
+        tree_free((u32*)n[2 + j], h - 1);
+    }
+    release_n(n, ARRAY_NODE_SIZE);
+}
+
+static u32*
+tree_leaf(u32* e, u32 k)  // new leaf holding k elements from e
+{
+    u32* l = (u32*)reserve();
+    if (!l) return NULL;  // fail!
+    u32 j;
+    for (j = 0; j < k; ++j) {
+        l[j] = e[j];
+    }
+    l[7] = k;
+    return l;
+}
+
+static u32*
+tree_insert(u32* n, u32 h, u32 total, u32 i, u32 e, u32** split)  // path-copy insert
+{
+    u32 k, j, t;
+    *split = NULL;
+    if (h == 0) {  // leaf
+        u32 buf[ARRAY_LEAF + 1];
+        k = n[7];
+        for (j = 0; j <= k; ++j) {
+            buf[j] = (j < i) ? n[j] : ((j == i) ? e : n[j - 1]);
+        }
+        if (++k <= ARRAY_LEAF) return tree_leaf(buf, k);
+        *split = tree_leaf(buf + (k / 2), k - (k / 2));
+        if (!*split) return NULL;  // fail!
+        return tree_leaf(buf, k / 2);
+    }
+    u32 sum = total + 1;  // element total after insert
+    k = n[0];
+    for (j = 0; j < (k - 1); ++j) {
+        t = tree_total((u32*)n[2 + j], h - 1);
+        if (i < t) break;
+        i -= t;
+        total -= t;
+    }
+    if (j == (k - 1)) {  // last child takes the rest
+        t = total;
+    }
+    u32* s;
+    u32* c = tree_insert((u32*)n[2 + j], h - 1, t, i, e, &s);
+    if (!c) return NULL;  // fail!
+    u32 len = s ? (k + 1) : k;  // children after insert
+    u32 half = (len > ARRAY_FANOUT) ? (len / 2) : len;  // children kept in copy
+    u32* m = (u32*)reserve_n(ARRAY_NODE_SIZE);  // copy of node
+    if (!m) return NULL;  // fail!
+    u32* r = NULL;
+    if (half < len) {  // split node in two
+        r = (u32*)reserve_n(ARRAY_NODE_SIZE);
+        if (!r) return NULL;  // fail!
+    }
+    for (i = 0; i < len; ++i) {
+        u32 w;
+        if (i < j) {
+            w = n[2 + i];  // shared child before the path
+        } else if (i == j) {
+            w = (u32)c;  // copied child on the path
+        } else if (s && (i == (j + 1))) {
+            w = (u32)s;  // new half of split child
+        } else {
+            w = n[(s ? 1 : 2) + i];  // shared child after the path
+        }
+        if (i < half) {
+            m[2 + i] = w;
+        } else {
+            r[2 + i - half] = w;
+        }
+    }
+    m[0] = half;
+    m[1] = sum;
+    if (r) {
+        t = 0;  // none of these is the last child
+        for (i = 0; i < half; ++i) {
+            t += tree_total((u32*)m[2 + i], h - 1);
+        }
+        r[0] = len - half;
+        r[1] = sum - t;
+        m[1] = t;
+    }
+    *split = r;
+    return m;
+}
+
+ACTOR*
+new_array_builder()  // allocate a builder for a new array
+{
+    struct example_5* a = (struct example_5*)new_array();  // array being built
+    if (!a) return NULL;  // fail!
+    struct example_5* x = (struct example_5*)reserve();  // new builder
+    if (!x) return NULL;  // fail!
+    x->data_04 = (u32)a;  // pointer to Array being mutated
+    x->data_08 = (u32)(&a->data_0c);  // pointer to next element slot
+    x->data_0c = (u32)(&a->data_18);  // pointer to link slot (end of block)
+    x->data_10 = 0;  // right-edge nodes, levels 1..4 (none while flat)
+    x->data_14 = 0;
+    x->data_18 = 0;
+    x->beh_1c = (ACTOR*)0;
+    return (ACTOR*)x;  // success.
+}
+
+static int
+array_attach(struct example_5* x, u32 level, u32 c)  // append child c at right edge
 {
-    struct example_5* x = (struct example_5*)sb;
-    struct example_5* s = (struct example_5*)x->data_04;
-    u8* p = (u8*)x->data_08;
-    u8* q = (u8*)x->data_0c;
-    int (*encode)(u8*,u32,int) = (int(*)(u8*,u32,int))(x->data_18);
-    int k = 0;
-    do {
-        if (p >= q) {  // out of space
-            struct example_5* y = (struct example_5*)reserve();
-            if (!y) return false;  // fail!
-            y->beh_1c = (ACTOR*)0;  // NULL next/link pointer
-            p = (u8*)y;  // update start
-            *((u32*)q) = (u32)p;  // link to next block
-            q = (p + 0x1c);
-            x->data_0c = (u32)q;  // update end
-        }
-        k = (*encode)(p, code, k);  // call encode procedure
-        if (k < 0) return false;  // fail!
-        ++(s->data_08);  // update count
-        x->data_08 = (u32)(++p);  // update start
-    } while (k > 0);
+    struct example_5* a = (struct example_5*)x->data_04;
+    u32* edge = &x->data_10;  // right-edge node for each level
+    u32* n = (u32*)edge[level - 1];
+    if (n[0] < ARRAY_FANOUT) {
+        n[2 + n[0]++] = c;
+        return true;  // success.
+    }
+    u32 j, t = 0;
+    for (j = 0; j < n[0]; ++j) {  // full node is complete, set its total
+        t += tree_total((u32*)n[2 + j], level - 1);
+    }
+    n[1] = t;
+    if (level == a->data_10) {  // root is full, add a level
+        if (level >= ARRAY_LEVELS) return false;  // fail!
+        u32* r = (u32*)reserve_n(ARRAY_NODE_SIZE);
+        if (!r) return false;  // fail!
+        r[0] = 1;
+        r[2] = (u32)n;
+        a->data_0c = (u32)r;
+        a->data_10 = level + 1;
+        edge[level] = (u32)r;
+    }
+    u32* m = (u32*)reserve_n(ARRAY_NODE_SIZE);  // new right-edge node
+    if (!m) return false;  // fail!
+    m[0] = 1;
+    m[2] = c;
+    edge[level - 1] = (u32)m;
+    return array_attach(x, level + 1, (u32)m);
+}
+
+static int
+array_grow(struct example_5* x)  // make room for next element in array being built
+{
+    struct example_5* a = (struct example_5*)x->data_04;
+    u32* q = (u32*)x->data_0c;
+    u32* l = (u32*)reserve();  // new block
+    if (!l) return false;  // fail!
+    if (array_element_count(a) < ARRAY_FLAT_MAX) {  // first extended block
+        l[7] = 0;  // NULL next/link pointer
+        *q = (u32)l;  // link to next block
+        x->data_08 = (u32)l;  // update start
+        x->data_0c = (u32)(l + 7);  // update end
+        return true;  // success.
+    }
+    if (!x->data_10) {  // convert flat array to tree form
+        u32* r = (u32*)reserve_n(ARRAY_NODE_SIZE);
+        if (!r) return false;  // fail!
+        u32* b = (u32*)a->data_18;  // extended block becomes 2nd leaf
+        l[0] = a->data_0c;
+        l[1] = a->data_10;
+        l[2] = a->data_14;
+        l[3] = b[0];
+        l[4] = b[1];
+        l[5] = b[2];
+        l[6] = b[3];
+        l[7] = 7;
+        b[0] = b[4];
+        b[1] = b[5];
+        b[2] = b[6];
+        b[7] = 3;
+        r[0] = 2;
+        r[2] = (u32)l;
+        r[3] = (u32)b;
+        ((struct cal_value*)a)->byte_04 = ARRAY_TREE;
+        a->data_0c = (u32)r;  // root node
+        a->data_10 = 1;  // node levels
+        a->data_18 = 0;  // no extended blocks
+        x->data_10 = (u32)r;  // right-edge node at level 1
+        x->data_08 = (u32)(b + 3);  // update start
+        x->data_0c = (u32)(b + 7);  // update end
+        return true;  // success.
+    }
+    l[7] = 0;  // empty leaf
+    if (!array_attach(x, 1, (u32)l)) {
+        release(l);
+        return false;  // fail!
+    }
+    x->data_08 = (u32)l;  // update start
+    x->data_0c = (u32)(l + 7);  // update end
     return true;  // success.
 }
 
-ACTOR*
-new_array()  // allocate a new (empty) array
+int
+array_append(ACTOR* ab, ACTOR* element)  // append element to array being built
 {
-    struct example_5* x = (struct example_5*)reserve();
-    if (!x) return NULL;  // fail!
-    struct example_5* y = (struct example_5*)(&v_array_0);
-    *x = *y;  // copy empty array template
-    return (ACTOR*)x;
+    struct example_5* x = (struct example_5*)ab;
+    struct example_5* a = (struct example_5*)x->data_04;
+    if (x->data_08 >= x->data_0c) {  // out of space
+        if (!array_grow(x)) return false;  // fail!
+    }
+    u32* p = (u32*)x->data_08;
+    *p++ = (u32)element;
+    x->data_08 = (u32)p;  // update start
+    if (x->data_10) {  // tree leaf keeps its own count
+        ++(*((u32*)x->data_0c));
+    }
+    a->data_08 += sizeof(u32);  // update size
+    return true;  // success.
 }
 
 ACTOR*
 array_insert(ACTOR* a, u32 index, ACTOR* element)  // insert element at (0-based) index
 {
-    ACTOR* b = NULL;
-
     struct example_5* x = (struct example_5*)a;
     u32 count = array_element_count(a);
     TRACE(puts("array_insert: a=0x"));
@@ -912,76 +1824,45 @@ array_insert(ACTOR* a, u32 index, ACTOR* element)  // insert element at (0-based
     TRACE(serial_hex32((u32)element));
     TRACE(putchar('\n'));
     if (x->beh_1c != &b_value) return NULL;  // fail! -- wrong actor type
-    if (index <= count) {
-        b = (ACTOR*)reserve();
-        struct example_5* y = (struct example_5*)b;
-        y->code_00 = x->code_00;  // copy code field
-        y->data_04 = x->data_04;  // copy array header
-        y->data_08 = x->data_08 + 4;  // increase size
-        y->data_18 = 0;  // NULL next/link pointer
-        y->beh_1c = x->beh_1c;  // copy actor behavior
-        u32 i = 0;  // index of pointer to copy
-        u32 n = 3;  // number of pointers in block
-        u32* w = &x->data_0c;  // src pointer
-        u32* v = &y->data_0c;  // dst pointer
-        TRACE(puts("array_insert: allocated b="));
-        TRACE(dump_words((u32*)b, 8));
-        // copy pointers before index
-        while (i < index) {
-            if (n == 0) {  // next block
-                x = (struct example_5*)(*w);
-                w = (u32*)x;
-                y = (struct example_5*)reserve();
-                if (!y) return NULL;  // fail!
-                y->beh_1c = (ACTOR*)0;  // NULL next/link pointer
-                *v = (u32)y;
-                v = (u32*)y;
-                n = 7;
-            }
-            *v++ = *w++;  // copy pointer
-            --n;
-            ++i;
-        }
-        // insert element at index
-        if (n == 0) {  // next block
-            x = (struct example_5*)(*w);
-            w = (u32*)x;
-            y = (struct example_5*)reserve();
-            if (!y) return NULL;  // fail!
-            y->beh_1c = (ACTOR*)0;  // NULL next/link pointer
-            *v = (u32)y;
-            v = (u32*)y;
-            n = 7;
-        }
-        TRACE(puts("array_insert: at v=0x"));
-        TRACE(serial_hex32((u32)v));
-        TRACE(puts(", i="));
-        TRACE(serial_dec32(i));
-        TRACE(puts(", n="));
-        TRACE(serial_dec32(n));
-        TRACE(puts(", element=0x"));
-        TRACE(serial_hex32((u32)element));
-        TRACE(putchar('\n'));
-        *v++ = (u32)element;
-        ++i;
-        // copy pointers after index
-        while (i <= count) {
-            if (n == 1) {  // next dst block
-                y = (struct example_5*)reserve();
-                if (!y) return NULL;  // fail!
-                y->beh_1c = (ACTOR*)0;  // NULL next/link pointer
-                *v = (u32)y;
-                v = (u32*)y;
-            } else if (n == 0) {  // next src block
-                x = (struct example_5*)(*w);
-                w = (u32*)x;
-                n = 7;
-            }
-            *v++ = *w++;  // copy pointer
-            --n;
-            ++i;
+    if (index > count) return NULL;  // fail!
+    if (array_tree(a)) {  // copy path to one leaf
+        u32* s;
+        u32 h = x->data_10;
+        u32* r = tree_insert((u32*)x->data_0c, h, count, index, (u32)element, &s);
+        if (!r) return NULL;  // fail!
+        if (s) {  // root split in two
+            u32* n = (u32*)reserve_n(ARRAY_NODE_SIZE);
+            if (!n) return NULL;  // fail!
+            n[0] = 2;
+            n[1] = count + 1;
+            n[2] = (u32)r;
+            n[3] = (u32)s;
+            r = n;
+            ++h;
         }
+        struct example_5* y = (struct example_5*)reserve();
+        if (!y) return NULL;  // fail!
+        *y = *x;  // copy array header
+        y->data_08 += sizeof(u32);  // increase size
+        y->data_0c = (u32)r;  // new root node
+        y->data_10 = h;
+        TRACE(puts("array_insert: returning b=0x"));
+        TRACE(serial_hex32((u32)y));
+        TRACE(putchar('\n'));
+        return (ACTOR*)y;
+    }
+    ACTOR* ab = new_array_builder();  // rebuild small array (at most 11 elements)
+    if (!ab) return NULL;  // fail!
+    ACTOR* it = new_collection_iterator(a);
+    if (!it) return NULL;  // fail!
+    u32 i;
+    for (i = 0; i <= count; ++i) {
+        ACTOR* v = (i == index) ? element : read_item(it);
+        if (!array_append(ab, v)) return NULL;  // fail!
     }
+    release(it);
+    ACTOR* b = get_array_built(ab);
+    release(ab);
     TRACE(puts("array_insert: returning b=0x"));
     TRACE(serial_hex32((u32)b));
     TRACE(putchar('\n'));
@@ -994,7 +1875,10 @@ array_element(ACTOR* a, u32 index)  // retrieve element at (0-based) index
     struct example_5* x = (struct example_5*)a;
     u32 count = array_element_count(a);
     if (index < count) {
-        if (index < 3) {
+        if (array_tree(a)) {
+            u32* l = array_leaf(a, &index);
+            return (ACTOR*)(l[index]);
+        } else if (index < 3) {
             u32* w = &x->data_0c;
             return (ACTOR*)(w[index]);
         } else {
@@ -1023,145 +1907,322 @@ new_object()  // allocate a new (empty) object
     return (ACTOR*)x;
 }
 
-ACTOR*
-object_set(ACTOR* o, ACTOR* name, ACTOR* value)  // set property in object
+/*
+ * Objects with OBJECT_HASH_MIN or more properties are hash-indexed.
+ * The header is marked with byte_04 = OBJECT_HASHED, data_0c points to
+ * a directory of index segments, and data_10 holds the index mask.
+ * Name/value pointers then start in the first extended block (data_18),
+ * so every name pointer lives in a 7-pointer block. Each index slot
+ * holds the address of a name pointer, or 0 if the slot is empty.
+ */
+#define OBJECT_HASHED       0x48  // header byte_04 marker ('H')
+#define OBJECT_HASH_MIN     8     // property count that triggers indexing
+#define INDEX_SEG_SLOTS     64    // slots per 256-byte index segment
+#define INDEX_SLOTS_MIN     (4 * OBJECT_HASH_MIN)
+#define INDEX_SLOTS_MAX     (64 * INDEX_SEG_SLOTS)  // 256-byte directory
+#define object_hashed(o)    (((struct cal_value*)(o))->byte_04 == OBJECT_HASHED)
+
+static u32
+string_hash(ACTOR* s)  // FNV-1a over code points, consistent with string_compare
 {
-    ACTOR* b = NULL;
+    u32 h = 0x811C9DC5;
+    u32 c;
+    ACTOR* it = new_string_iterator(s);
+    if (!it) return 0;  // unsupported encoding, hash to a single bucket
+    while ((c = read_code(it)) != EOF) {
+        h = (h ^ c) * 0x01000193;
+    }
+    release(it);
+    return h;
+}
 
-    struct example_5* x = (struct example_5*)o;
-    u32 count = object_property_count(o);
-    TRACE(puts("object_set: o=0x"));
-    TRACE(serial_hex32((u32)o));
-    TRACE(puts(", count="));
-    TRACE(serial_dec32(count));
-    TRACE(puts(", name=0x"));
-    TRACE(serial_hex32((u32)name));
-    TRACE(puts(", value=0x"));
-    TRACE(serial_hex32((u32)value));
-    TRACE(putchar('\n'));
-    if (x->beh_1c != &b_value) return NULL;  // fail! -- wrong actor type
-    TRACE(puts("object_set: name="));
-    TRACE(dump_words((u32*)name, 8));
-    TRACE(puts("object_set: value="));
-    TRACE(dump_words((u32*)value, 8));
-    b = (ACTOR*)reserve();
-    struct example_5* y = (struct example_5*)b;
-    y->code_00 = x->code_00;  // copy code field
-    y->data_04 = x->data_04;  // copy object header
-    y->data_08 = x->data_08;  // copy size
-    y->data_18 = 0;  // NULL next/link pointer
-    y->beh_1c = x->beh_1c;  // copy actor behavior
-    u32 n = 3;  // number of pointers in block
-    u32* w = &x->data_0c;  // src pointer
-    u32* v = &y->data_0c;  // dst pointer
-    TRACE(puts("object_set: allocated b="));
-    TRACE(dump_words((u32*)b, 8));
-    // copy properties while searching for name match
-    int d = MIN_INT;
-    while (count > 0) {
-        if (n == 0) {  // next block
-            x = (struct example_5*)(*w);
-            w = (u32*)x;
-            y = (struct example_5*)reserve();
-            if (!y) return NULL;  // fail!
-            y->beh_1c = (ACTOR*)0;  // NULL next/link pointer
-            *v = (u32)y;
-            v = (u32*)y;
-            n = 7;
-        }
-        if (d != 0) {  // only compare names if not already found
-            d = string_compare(name, (ACTOR*)(*w));
-            TRACE(puts("object_set: string_compare("));
-            TRACE(to_JSON(name, 0, MAX_INT));
-            TRACE(puts(", "));
-            TRACE(to_JSON((ACTOR*)(*w), 0, MAX_INT));
-            TRACE(puts(") = "));
-            TRACE(serial_int32(d));
-            TRACE(putchar('\n'));
-            if (d == MIN_INT) return NULL;  // fail!
-            if (d == 0) {  // name matched
-                *v++ = *w++;  // copy name pointer
-                --n;
-                if (n == 0) {  // next block
-                    x = (struct example_5*)(*w);
-                    w = (u32*)x;
-                    y = (struct example_5*)reserve();
-                    if (!y) return NULL;  // fail!
-                    y->beh_1c = (ACTOR*)0;  // NULL next/link pointer
-                    *v = (u32)y;
-                    v = (u32*)y;
-                    n = 7;
-                }
-                *v++ = (u32)value;  // replace value pointer
-                ++w;  // skip src value pointer
-                --n;
-                --count;  // decement property count
-                continue;  // next loop iteration
+static void
+index_free(u32* dir, u32 m)  // release index directory with m slots
+{
+    u32 segs = (m + INDEX_SEG_SLOTS - 1) / INDEX_SEG_SLOTS;
+    u32 seg_size = ((m < INDEX_SEG_SLOTS) ? m : INDEX_SEG_SLOTS) * sizeof(u32);
+    u32 dir_size = (segs < 8) ? 32 : (segs * sizeof(u32));
+    u32 i;
+
+    for (i = 0; i < segs; ++i) {
+        if (dir[i]) release_n((void*)dir[i], seg_size);
+    }
+    release_n(dir, dir_size);
+}
+
+/*
+ * Release a value built by the decoder, with all of its parts.
+ * Static values are shared and never released. A string slice owns only
+ * its header, since its octets belong to the source string.
+ */
+static void
+release_value(ACTOR* v)
+{
+    struct cal_value* x = (struct cal_value*)v;
+    if (!v || ((u8*)v < heap_start)) return;  // static value
+    u8 prefix = value_prefix(v);
+    if ((prefix & 0xF8) == 0x00) {  // Array/Object type
+        ACTOR* it = new_collection_iterator(v);
+        if (it) {
+            ACTOR* a;
+            while ((a = read_item(it)) != NULL) {
+                release_value(a);
             }
+            release(it);
         }
-        *v++ = *w++;  // copy name pointer
-        --n;
-        if (n == 0) {  // next block
-            x = (struct example_5*)(*w);
-            w = (u32*)x;
-            y = (struct example_5*)reserve();
-            if (!y) return NULL;  // fail!
-            y->beh_1c = (ACTOR*)0;  // NULL next/link pointer
-            *v = (u32)y;
-            v = (u32*)y;
-            n = 7;
+        if (object_hashed(v) && x->data_0c) {
+            index_free((u32*)x->data_0c, x->data_10 + 1);
         }
-        *v++ = *w++;  // copy value pointer
-        --n;
-        --count;  // decement property count
+        if (array_tree(v)) {  // decoded trees share no blocks
+            tree_free((u32*)x->data_0c, x->data_10);
+        }
+    } else if (((prefix & 0xF8) != 0x08) || string_slice(v)) {  // single block
+        release(v);
+        return;
     }
-    if (d != 0) {  // no match found, append new property
-        TRACE(puts("object_set: no match found, append new property.\n"));
-        if (n == 0) {  // next block
-            y = (struct example_5*)reserve();
-            if (!y) return NULL;  // fail!
-            y->beh_1c = (ACTOR*)0;  // NULL next/link pointer
-            *v = (u32)y;
-            v = (u32*)y;
-            n = 7;
+    struct example_5* y = (struct example_5*)(x->data_18);
+    while (y) {  // release extended blocks
+        struct example_5* z = (struct example_5*)(y->beh_1c);
+        release(y);
+        y = z;
+    }
+    release(v);
+}
+
+static u32*
+index_alloc(u32 m)  // allocate empty index directory with m slots
+{
+    u32 segs = (m + INDEX_SEG_SLOTS - 1) / INDEX_SEG_SLOTS;
+    u32 seg_size = ((m < INDEX_SEG_SLOTS) ? m : INDEX_SEG_SLOTS) * sizeof(u32);
+    u32 dir_size = (segs < 8) ? 32 : (segs * sizeof(u32));
+    u32 i, j;
+
+    u32* dir = (u32*)reserve_n(dir_size);
+    if (!dir) return NULL;  // fail!
+    for (i = 0; i < segs; ++i) {
+        dir[i] = 0;
+    }
+    for (i = 0; i < segs; ++i) {
+        u32* p = (u32*)reserve_n(seg_size);
+        if (!p) {
+            index_free(dir, m);
+            return NULL;  // fail!
+        }
+        for (j = 0; j < (seg_size / sizeof(u32)); ++j) {
+            p[j] = 0;  // empty slot
+        }
+        dir[i] = (u32)p;
+    }
+    return dir;
+}
+
+static u32*
+index_probe(struct cal_value* o, ACTOR* name, u32 h)  // find slot for name, or empty slot
+{
+    u32* dir = (u32*)o->data_0c;
+    u32 mask = o->data_10;
+
+    for (;;) {  // linear probing, load factor <= 1/2 ensures an empty slot
+        u32 i = h & mask;
+        u32* e = ((u32*)dir[i / INDEX_SEG_SLOTS]) + (i % INDEX_SEG_SLOTS);
+        if (*e == 0) return e;  // empty slot
+        if (string_compare(name, (ACTOR*)(*((u32*)(*e)))) == 0) return e;  // name matched
+        ++h;
+    }
+}
+
+static int
+index_build(struct cal_value* o, u32 m)  // (re)build hash index with m slots
+{
+    if (m > INDEX_SLOTS_MAX) return false;  // fail! -- too many properties
+    u32* dir = index_alloc(m);
+    if (!dir) return false;  // fail!
+    if (o->data_0c) {
+        index_free((u32*)o->data_0c, o->data_10 + 1);
+    }
+    o->data_0c = (u32)dir;
+    o->data_10 = m - 1;
+    u32 n = o->data_08 >> 2;  // number of pointers
+    u32* p = &o->data_18;
+    u32* q = p;
+    while (n > 0) {
+        if (p >= q) {  // next block
+            p = (u32*)(*q);
+            q = p + 7;
         }
-        *v++ = (u32)name;  // new name pointer
+        if ((n & 1) == 0) {  // name pointer
+            ACTOR* name = (ACTOR*)(*p);
+            u32* e = index_probe(o, name, string_hash(name));
+            *e = (u32)p;
+        }
+        ++p;
         --n;
-        if (n == 0) {  // next block
-            y = (struct example_5*)reserve();
-            if (!y) return NULL;  // fail!
-            y->beh_1c = (ACTOR*)0;  // NULL next/link pointer
-            *v = (u32)y;
-            v = (u32*)y;
-            n = 7;
+    }
+    return true;  // success.
+}
+
+static u32*
+object_find(ACTOR* o, ACTOR* name)  // address of property value pointer, or NULL
+{
+    struct cal_value* x = (struct cal_value*)o;
+    if (object_hashed(o)) {
+        u32* e = index_probe(x, name, string_hash(name));
+        if (*e == 0) return NULL;  // not found
+        u32* p = ((u32*)(*e)) + 1;
+        if (((u32)p & 0x1F) == 0x1C) {  // link slot, value starts next block
+            p = (u32*)(*p);
         }
-        *v++ = (u32)value;  // new value pointer
-        //--n;  <-- don't need to update because we're done here!
-        x = (struct example_5*)o;
-        y = (struct example_5*)b;
-        y->data_08 = x->data_08 + 8;  // increase size
+        return p;
     }
-    TRACE(puts("object_set: returning b=0x"));
-    TRACE(serial_hex32((u32)b));
-    TRACE(putchar('\n'));
-    return b;
+    u32 n = x->data_08 >> 2;  // number of pointers
+    u32* p = &x->data_0c;
+    u32* q = p + 3;
+    int d = MIN_INT;
+    while (n > 0) {
+        if (p >= q) {  // next block
+            p = (u32*)(*q);
+            q = p + 7;
+        }
+        if (d == 0) return p;  // value following matched name
+        if ((n & 1) == 0) {  // name pointer
+            d = string_compare(name, (ACTOR*)(*p));
+        }
+        ++p;
+        --n;
+    }
+    return NULL;  // not found
+}
+
+static u32*
+object_slot(struct example_5* x)  // allocate next pointer slot in object being built
+{
+    u32* p = (u32*)x->data_08;
+    u32* q = (u32*)x->data_0c;
+    if (p >= q) {  // out of space
+        struct example_5* y = (struct example_5*)reserve();
+        if (!y) return NULL;  // fail!
+        y->beh_1c = (ACTOR*)0;  // NULL next/link pointer
+        *q = (u32)y;  // link to next block
+        p = (u32*)y;  // update start
+        x->data_0c = (u32)(p + 7);  // update end
+    }
+    x->data_08 = (u32)(p + 1);  // update start
+    return p;
+}
+
+static int
+object_convert(struct example_5* x)  // rewrite object being built in hashed form
+{
+    struct cal_value* o = (struct cal_value*)x->data_04;
+    u32 w[2 * OBJECT_HASH_MIN];
+    u32 n = o->data_08 >> 2;  // number of pointers
+    u32 i;
+
+    if (n > (2 * OBJECT_HASH_MIN)) return false;  // fail!
+    ACTOR* it = new_collection_iterator((ACTOR*)o);
+    if (!it) return false;  // fail!
+    for (i = 0; i < n; ++i) {
+        w[i] = (u32)read_item(it);
+    }
+    release(it);
+    struct example_5* y = (struct example_5*)(o->data_18);
+    while (y) {  // release extended blocks, owned by builder
+        struct example_5* z = (struct example_5*)(y->beh_1c);
+        release(y);
+        y = z;
+    }
+    o->byte_04 = OBJECT_HASHED;
+    o->data_0c = 0;  // no index yet
+    o->data_10 = 0;
+    o->data_18 = 0;  // NULL next/link pointer
+    x->data_08 = (u32)(&o->data_18);  // properties start in extended block
+    x->data_0c = (u32)(&o->data_18);
+    for (i = 0; i < n; ++i) {
+        u32* p = object_slot(x);
+        if (!p) return false;  // fail!
+        *p = w[i];
+    }
+    return index_build(o, INDEX_SLOTS_MIN);
+}
+
+static int
+object_add(struct example_5* x, ACTOR* name, ACTOR* value)  // append new property
+{
+    struct cal_value* o = (struct cal_value*)x->data_04;
+    u32* n = object_slot(x);
+    if (!n) return false;  // fail!
+    *n = (u32)name;
+    u32* v = object_slot(x);
+    if (!v) return false;  // fail!
+    *v = (u32)value;
+    o->data_08 += 2 * sizeof(u32);  // update size
+    u32 count = object_property_count(o);
+    if (object_hashed(o)) {
+        u32 m = o->data_10 + 1;
+        if ((count << 1) > m) return index_build(o, m << 1);  // grow index
+        u32* e = index_probe(o, name, string_hash(name));
+        *e = (u32)n;
+    } else if (count >= OBJECT_HASH_MIN) {
+        return object_convert(x);
+    }
+    return true;  // success.
 }
 
 ACTOR*
-object_get(ACTOR* o, ACTOR* name)  // get property value from object
+new_object_builder()  // allocate a builder for a new object
+{
+    struct example_5* o = (struct example_5*)new_object();  // object being built
+    if (!o) return NULL;  // fail!
+    struct example_5* x = (struct example_5*)reserve();  // new builder
+    if (!x) return NULL;  // fail!
+    x->data_04 = (u32)o;  // pointer to Object being mutated
+    x->data_08 = (u32)(&o->data_0c);  // pointer to next pointer slot
+    x->data_0c = (u32)(&o->data_18);  // pointer to link slot (end of block)
+    return (ACTOR*)x;  // success.
+}
+
+int
+object_append(ACTOR* ob, ACTOR* name, ACTOR* value)  // set property in object being built
+{
+    struct example_5* x = (struct example_5*)ob;
+    u32* p = object_find((ACTOR*)(x->data_04), name);
+    if (p) {  // name matched
+        *p = (u32)value;  // replace value pointer
+        return true;  // success.
+    }
+    return object_add(x, name, value);
+}
+
+ACTOR*
+object_set(ACTOR* o, ACTOR* name, ACTOR* value)  // set property in (copy of) object
 {
     ACTOR* a = NULL;
+
+    struct example_5* x = (struct example_5*)o;
+    if (x->beh_1c != &b_value) return NULL;  // fail! -- wrong actor type
+    ACTOR* ob = new_object_builder();
+    if (!ob) return NULL;  // fail!
     ACTOR* it = new_collection_iterator(o);
     if (!it) return NULL;  // fail!
-    while ((a = read_item(it)) != NULL) {
-        int d = string_compare(name, a);
-        a = read_item(it);  // get value
-        if (a == NULL) return NULL;  // fail!
-        if (d == 0) {  // name matched
-            return a;  // success.
-        }
+    while ((a = read_item(it)) != NULL) {  // copy properties (names are unique)
+        if (!object_add((struct example_5*)ob, a, read_item(it))) return NULL;  // fail!
     }
-    return NULL;  // fail!
+    release(it);
+    if (!object_append(ob, name, value)) return NULL;  // fail!
+    a = get_object_built(ob);
+    release(ob);
+    TRACE(puts("object_set: returning a=0x"));
+    TRACE(serial_hex32((u32)a));
+    TRACE(putchar('\n'));
+    return a;
+}
+
+ACTOR*
+object_get(ACTOR* o, ACTOR* name)  // get property value from object
+{
+    u32* p = object_find(o, name);
+    if (!p) return NULL;  // fail!
+    return (ACTOR*)(*p);  // success.
 }
 
 ACTOR*
@@ -1179,6 +2240,15 @@ new_collection_iterator(ACTOR* c)
     x->data_04 = w;  // total octets remaining
     x->data_08 = (u32)p;  // starting address
     x->data_0c = (u32)(p + 3);  // ending address
+    x->data_10 = 0;  // no tree
+    if (object_hashed(c)) {  // properties start in first extended block
+        x->data_08 = x->data_0c;
+    }
+    if (array_tree(c)) {  // elements start in first leaf
+        x->data_08 = x->data_0c;
+        x->data_10 = (u32)c;  // tree being walked
+        x->data_14 = 0;  // index of first element in next leaf
+    }
     return (ACTOR*)x;  // success.
 }
 
@@ -1191,8 +2261,16 @@ read_item(ACTOR* it)
         u32* p = (u32*)x->data_08;
         u32* q = (u32*)x->data_0c;
         if (p >= q) {  // out of bounds
-            p = (u32*)(*q);  //  load next block of data
-            x->data_0c = (u32)(p + 7);  // update end
+            if (x->data_10) {  // find next leaf of tree
+                u32 i = x->data_14;
+                p = array_leaf((ACTOR*)x->data_10, &i);
+                q = p + p[7];
+                x->data_14 += p[7];
+            } else {
+                p = (u32*)(*q);  //  load next block of data
+                q = p + 7;
+            }
+            x->data_0c = (u32)q;  // update end
         }
         u32 w = *p++;
         x->data_04 = n - sizeof(u32);  // update count
@@ -1204,144 +2282,193 @@ read_item(ACTOR* it)
 
 /*
  * conversion from internal representation to JSON string
+ *
+ * Output goes through write_code(), so the target may be a buffered
+ * sink or a string builder. A negative indent selects compact output.
+ * Collections beyond the nesting limit are shown as "..." unvisited.
  */
 
+static char hex_digit[] = "0123456789abcdef";
+
+static int
+json_puts(ACTOR* sk, char* s)  // write C-string
+{
+    u32 c;
+
+    while ((c = (u8)(*s++))) {
+        if (!write_code(sk, c)) return false;  // fail!
+    }
+    return true;  // success.
+}
+
+static int
+json_dec(ACTOR* sk, u32 w)  // write unsigned decimal
+{
+    char dec[12];
+    char *p = dec + sizeof(dec);
+
+    *--p = '\0';
+    do {
+        *--p = (char)((w % 10) + '0');
+        w /= 10;
+    } while (w && (p > dec));
+    return json_puts(sk, p);
+}
+
+static int
+json_u16(ACTOR* sk, u32 w)  // write "\uXXXX" escape
+{
+    return write_code(sk, '\\')
+        && write_code(sk, 'u')
+        && write_code(sk, hex_digit[0xF & (w >> 12)])
+        && write_code(sk, hex_digit[0xF & (w >> 8)])
+        && write_code(sk, hex_digit[0xF & (w >> 4)])
+        && write_code(sk, hex_digit[0xF & w]);
+}
+
+static int
+json_space(ACTOR* sk, int indent)  // space between values
+{
+    if (indent > 0) {
+        if (!write_code(sk, '\n')) return false;  // fail!
+        while (--indent > 0) {
+            if (!json_puts(sk, "  ")) return false;  // indent 2 spaces
+        }
+        return true;  // success.
+    }
+    if (indent < 0) return true;  // compact
+    return write_code(sk, ' ');
+}
+
 static int
-number_to_JSON(ACTOR* a)
+number_to_JSON(ACTOR* sk, ACTOR* a)
 {
     u8* p = (u8*)a;
     u8 b = *(p + 0x05);
 
     if ((b & ~0x7) == p_int_0) {
         u32 w = *((u32*)(p + 0x08));
-        serial_dec32(w);
+        return json_dec(sk, w);
     } else if ((b & ~0x7) == m_int_0) {
         int n = *((int*)(p + 0x08));
-        serial_int32(n);
-    } else {
-        // FIXME: handle different number formats and bignums...
-        return false;  // fail!
+        if (n >= 0) return json_dec(sk, n);
+        return write_code(sk, '-') && json_dec(sk, 0 - (u32)n);
     }
-    return true;  // success.
+    // FIXME: handle different number formats and bignums...
+    return false;  // fail!
 }
 
 static int
-string_to_JSON(ACTOR* a)
+string_to_JSON(ACTOR* sk, ACTOR* a)
 {
+    int ok = true;
     u32 ch = EOF;
     ACTOR* it = new_string_iterator(a);
     if (!it) return false;  // fail!
-    putchar('"');
-    while ((ch = read_code(it)) != EOF) {
+    ok = write_code(sk, '"');
+    while (ok && ((ch = read_code(it)) != EOF)) {
         switch (ch) {
-            case 0x0022:    puts("\\\"");   break;
-            case 0x005C:    puts("\\\\");   break;
-            case 0x002F:    puts("\\/");    break;
-            case 0x0008:    puts("\\b");    break;
-            case 0x000C:    puts("\\f");    break;
-            case 0x000A:    puts("\\n");    break;
-            case 0x000D:    puts("\\r");    break;
-            case 0x0009:    puts("\\t");    break;
+            case 0x0022:    ok = json_puts(sk, "\\\"");     break;
+            case 0x005C:    ok = json_puts(sk, "\\\\");     break;
+            case 0x002F:    ok = json_puts(sk, "\\/");      break;
+            case 0x0008:    ok = json_puts(sk, "\\b");      break;
+            case 0x000C:    ok = json_puts(sk, "\\f");      break;
+            case 0x000A:    ok = json_puts(sk, "\\n");      break;
+            case 0x000D:    ok = json_puts(sk, "\\r");      break;
+            case 0x0009:    ok = json_puts(sk, "\\t");      break;
             default:
                 if ((ch < 0x0020) || (ch >= 0x007F)) {
                     if (ch >= 0x10000) {  // encode surrogate pair
                         ch -= 0x10000;
-                        u32 w = (ch >> 10) + 0xD800;  // hi 10 bits
-                        puts("\\u");
-                        serial_hex8(w >> 8);
-                        serial_hex8(w);
-                        w = (ch & 0x03FF) + 0xDC00;  // lo 10 bits
-                        puts("\\u");
-                        serial_hex8(w >> 8);
-                        serial_hex8(w);
+                        ok = json_u16(sk, (ch >> 10) + 0xD800)  // hi 10 bits
+                          && json_u16(sk, (ch & 0x03FF) + 0xDC00);  // lo 10 bits
                     } else {  // encode unicode hexadecimal escape
-                        puts("\\u");
-                        serial_hex8(ch >> 8);
-                        serial_hex8(ch);
+                        ok = json_u16(sk, ch);
                     }
                 } else {
-                    putchar(ch);
+                    ok = write_code(sk, ch);
                 }
                 break;
         }
     }
-    putchar('"');
-    return true;  // success.
+    release(it);
+    return ok && write_code(sk, '"');
 }
 
+static int value_to_JSON(ACTOR* sk, ACTOR* a, int indent, int limit);
+
 static int
-array_to_JSON(ACTOR* a, int indent, int limit)
+array_to_JSON(ACTOR* sk, ACTOR* a, int indent, int limit)
 {
-    putchar('[');
+    if (!write_code(sk, '[')) return false;  // fail!
     if (array_element_count(a) > 0) {
         if (limit < 1) {
-            puts("...");
+            if (!json_puts(sk, "...")) return false;  // fail!
         } else {
             ACTOR* it = new_collection_iterator(a);
             if (!it) return false;  // fail!
-            if (indent) {
-                space(++indent);
+            if ((indent > 0) && !json_space(sk, ++indent)) {
+                release(it);
+                return false;  // fail!
             }
+            int ok = true;
             int first = true;
-            while ((a = read_item(it)) != NULL) {
+            while (ok && ((a = read_item(it)) != NULL)) {
                 if (first) {
                     first = false;
-                } else {
-                    putchar(',');
-                    space(indent);
+                } else if (!write_code(sk, ',') || !json_space(sk, indent)) {
+                    ok = false;  // fail!
+                    break;
                 }
-                if (!to_JSON(a, indent, limit - 1)) return false;  // fail!
-            }
-            if (indent) {
-                space(--indent);
+                ok = value_to_JSON(sk, a, indent, limit - 1);
             }
+            release(it);
+            if (!ok) return false;  // fail!
+            if ((indent > 0) && !json_space(sk, --indent)) return false;  // fail!
         }
     }
-    putchar(']');
-    return true;  // success.
+    return write_code(sk, ']');
 }
 
 static int
-object_to_JSON(ACTOR* a, int indent, int limit)
+object_to_JSON(ACTOR* sk, ACTOR* a, int indent, int limit)
 {
-    putchar('{');
+    if (!write_code(sk, '{')) return false;  // fail!
     if (object_property_count(a) > 0) {
         if (limit < 1) {
-            puts("...");
+            if (!json_puts(sk, "...")) return false;  // fail!
         } else {
             ACTOR* it = new_collection_iterator(a);
             if (!it) return false;  // fail!
-            if (indent) {
-                space(++indent);
+            if ((indent > 0) && !json_space(sk, ++indent)) {
+                release(it);
+                return false;  // fail!
             }
+            int ok = true;
             int first = true;
-            while ((a = read_item(it)) != NULL) {
+            while (ok && ((a = read_item(it)) != NULL)) {
                 if (first) {
                     first = false;
-                } else {
-                    putchar(',');
-                    space(indent);
-                }
-                if (!string_to_JSON(a)) return false;  // fail!
-                putchar(':');
-                if (indent) {
-                    putchar(' ');
+                } else if (!write_code(sk, ',') || !json_space(sk, indent)) {
+                    ok = false;  // fail!
+                    break;
                 }
-                a = read_item(it);
-                if (a == NULL) return false;  // fail!
-                if (!to_JSON(a, indent, limit - 1)) return false;  // fail!
-            }
-            if (indent) {
-                space(--indent);
+                ok = string_to_JSON(sk, a)
+                  && write_code(sk, ':')
+                  && ((indent <= 0) || write_code(sk, ' '))
+                  && ((a = read_item(it)) != NULL)
+                  && value_to_JSON(sk, a, indent, limit - 1);
             }
+            release(it);
+            if (!ok) return false;  // fail!
+            if ((indent > 0) && !json_space(sk, --indent)) return false;  // fail!
         }
     }
-    putchar('}');
-    return true;  // success.
+    return write_code(sk, '}');
 }
 
-int
-to_JSON(ACTOR* a, int indent, int limit)
+static int
+value_to_JSON(ACTOR* sk, ACTOR* a, int indent, int limit)
 {
     int ok = true;
     struct example_5* x = (struct example_5*)a;
@@ -1349,25 +2476,55 @@ to_JSON(ACTOR* a, int indent, int limit)
     u8 b = *(p + 0x05);
 
     if (x->beh_1c != &b_value) {
-        putchar('<');
-        serial_hex32((u32)a);
-        putchar('>');
-        ok = false;  // fail! -- wrong actor type
+        int i;
+        ok = write_code(sk, '<');
+        for (i = 28; ok && (i >= 0); i -= 4) {
+            ok = write_code(sk, hex_digit[0xF & ((u32)a >> i)]);
+        }
+        if (ok) write_code(sk, '>');
+        return false;  // fail! -- wrong actor type (stop at first write error)
     } else if (b == null) {
-        prints("null");
+        ok = json_puts(sk, "null");
     } else if (b == true) {
-        prints("true");
+        ok = json_puts(sk, "true");
     } else if (b == false) {
-        prints("false");
+        ok = json_puts(sk, "false");
     } else if ((b & 0xF8) == 0x08) {  // String type (2#0000_1xxx)
-        ok = string_to_JSON(a);
+        ok = string_to_JSON(sk, a);
     } else if ((b & 0xF9) == 0x00) {  // Array type (2#0000_0xx0) != false
-        ok = array_to_JSON(a, indent, limit);
+        ok = array_to_JSON(sk, a, indent, limit);
     } else if ((b & 0xF9) == 0x01) {  // Object type (2#0000_0xx1) != true
-        ok = object_to_JSON(a, indent, limit);
+        ok = object_to_JSON(sk, a, indent, limit);
     } else {
-        ok = number_to_JSON(a);
+        ok = number_to_JSON(sk, a);
+    }
+    return ok;
+}
+
+int
+to_JSON_sink(ACTOR* sk, ACTOR* a, int indent, int limit)  // JSON into sink/builder
+{
+    return value_to_JSON(sk, a, indent, limit);
+}
+
+static int
+console_flush(void* ctx, const u8* data, int n)  // sink flush to console
+{
+    putbuf(data, n);
+    return n;
+}
+
+int
+to_JSON(ACTOR* a, int indent, int limit)  // JSON to console
+{
+    u8 buf[64];
+    ACTOR* sk = new_buffer_sink(buf, sizeof(buf), console_flush, NULL);
+    if (!sk) return false;  // fail!
+    int ok = value_to_JSON(sk, a, indent, limit);
+    if (!sink_flush(sk)) {
+        ok = false;  // fail!
     }
+    release(sk);
     return ok;
 }
 
@@ -1621,6 +2778,56 @@ test_collection()
         putchar('\n');
     }
 
+    ACTOR* ab = new_array_builder();  // builder must match repeated insert
+    b = new_array();
+    for (n = 0; n < 20; ++n) {
+        assert(array_append(ab, new_int(n)));
+        b = array_insert(b, n, new_int(n));
+    }
+    assert_eq(20, array_element_count(get_array_built(ab)));
+    assert(value_equal(b, get_array_built(ab)));
+    assert(value_equal(new_int(13), array_element(get_array_built(ab), 13)));
+    to_JSON(get_array_built(ab), 0, MAX_INT);
+    putchar('\n');
+    release(ab);
+
+    static u32 tree_ref[1000];  // expected elements of tree-form array
+    ab = new_array_builder();  // builder adds tree levels as it appends
+    for (n = 0; n < 500; ++n) {
+        tree_ref[n] = (u32)new_int(n);
+        assert(array_append(ab, (ACTOR*)tree_ref[n]));
+    }
+    a = get_array_built(ab);
+    release(ab);
+    assert(array_tree(a));
+    assert_eq(2, ((struct cal_value*)a)->data_10);  // node levels
+    b = a;  // version built by appending
+    for (n = 500; n < 1000; ++n) {  // inserts split leaves and nodes
+        u32 i = (n * 7919) % (n + 1);
+        if ((n % 50) == 0) i = 0;
+        if ((n % 50) == 1) i = n;
+        ACTOR* v = new_int(n);
+        a = array_insert(a, i, v);
+        assert(a);
+        u32 j;
+        for (j = n; j > i; --j) {
+            tree_ref[j] = tree_ref[j - 1];
+        }
+        tree_ref[i] = (u32)v;
+    }
+    assert_eq(1000, array_element_count(a));
+    ACTOR* it = new_collection_iterator(a);
+    for (n = 0; n < 1000; ++n) {
+        assert_eq(tree_ref[n], (u32)array_element(a, n));
+        assert_eq(tree_ref[n], (u32)read_item(it));
+    }
+    assert_eq(NULL, read_item(it));
+    release(it);
+    assert_eq(500, array_element_count(b));  // earlier version is unchanged
+    for (n = 0; n < 500; ++n) {
+        assert_eq(n, number_int(array_element(b, n)));
+    }
+
     ACTOR* o = new_object();
     dump_extended(o);
     to_JSON(o, 0, MAX_INT);
@@ -1675,6 +2882,24 @@ test_collection()
     to_JSON(b, 0, MAX_INT);
     putchar('\n');
 
+    ACTOR* h = new_object();  // large objects switch to hashed form
+    ACTOR* ob = new_object_builder();
+    for (n = 0; n < 20; ++n) {
+        u8 k[] = { 'k', 'a' + n };
+        h = object_set(h, new_octets(k, sizeof(k)), new_int(n));
+        assert(object_append(ob, new_octets(k, sizeof(k)), new_int(n)));
+    }
+    assert(object_append(ob, new_literal("kc"), new_int(-2)));
+    h = object_set(h, new_literal("kc"), new_int(-2));
+    assert_eq(20, object_property_count(h));
+    assert(value_equal(h, get_object_built(ob)));
+    assert(value_equal(new_int(-2), object_get(h, new_literal("kc"))));
+    assert(value_equal(new_int(19), object_get(get_object_built(ob), new_literal("kt"))));
+    assert_eq(NULL, object_get(h, new_literal("q")));
+    to_JSON(h, 0, MAX_INT);
+    putchar('\n');
+    release(ob);
+
     a = array_insert(a, 0, o);
     to_JSON(a, 1, 0);
     newline();
@@ -1706,6 +2931,11 @@ static u8 buf_octets_u16_20[] = { octets, p_int_0, n_2, 20, 0,
 static u8 buf_utf8_u16_20[] = { utf8, p_int_0, n_2, 20, 0,
     '<', '=', ' ', 't', 'w', 'e', 'n', 't', 'y', ' ',
     'c', 'h', 'a', 'r', 'a', 'c', 't', 'e', 'r', 's' };
+static u8 buf_utf8_u16_40[] = { utf8, p_int_0, n_2, 40, 0,
+    'a', ' ', 's', 'l', 'i', 'c', 'e', ' ', 'o', 'f',
+    ' ', 't', 'h', 'e', ' ', 'e', 'n', 'c', 'o', 'd',
+    'e', 'd', ' ', 'i', 'n', 'p', 'u', 't', ' ', 'b',
+    'u', 'f', 'f', 'e', 'r', ' ', '(', '4', '0', ')' };
 static u8 buf_utf16_u16_10[] = { utf16, p_int_0, n_2, 20, 0,
     0, '<', 0, '=', 0, ' ', 0, '1', 0, '0',
     0, ' ', 0, 'c', 0, 'h', 0, 'a', 0, 'r' };
@@ -1913,6 +3143,21 @@ test_decode()
         newline();
     }
 
+    a = new_octets(buf_utf8_u16_40, sizeof(buf_utf8_u16_40));  // zero-copy slice
+    b = decode_bose(new_string_iterator(a));
+    assert(b && string_slice(b));
+    assert_eq(0, string_compare(b, new_literal("a slice of the encoded input buffer (40)")));
+    a = new_string_slice(b, 15, 22);
+    assert_eq(0, string_compare(a, new_literal("encoded input buffer (")));
+    to_JSON(a, 1, MAX_INT);
+    putchar(' ');
+    to_JSON(b, 1, MAX_INT);
+    newline();
+    a = new_string_builder(octets);
+    assert(encode_bose(a, b));
+    a = get_string_built(a);
+    assert(value_equal(b, decode_bose(new_string_iterator(a))));
+
     a = new_octets(buf_utf16_u16_10, sizeof(buf_utf16_u16_10));
     dump_extended(a);
     b = decode_bose(new_string_iterator(a));
@@ -1981,6 +3226,43 @@ test_decode()
         to_JSON(b, 0, 2);
         newline();
     }
+
+    assert(sizeof(struct bose_stream) <= STREAM_SIZE);
+    ACTOR* ds = new_bose_stream(NULL, 0);  // push decoder, in 5-octet chunks
+    assert(ds);
+    for (i = 0; i < sizeof(buf_0); i += 5) {
+        int n = sizeof(buf_0) - i;
+        assert(bose_stream_write(ds, buf_0 + i, (n < 5) ? n : 5));
+    }
+    assert(value_equal(b, ((struct bose_stream*)ds)->last));
+    assert(bose_stream_write(ds, buf_utf8_u16_40, sizeof(buf_utf8_u16_40)));
+    assert(string_compare(((struct bose_stream*)ds)->last, new_literal("a slice of the encoded input buffer (40)")) == 0);
+    u8 bad[] = { array, n_3, p_dec_0, n_0, n_0 };
+    assert(!bose_stream_write(ds, bad, sizeof(bad)));  // resync after failure
+    u8 miscount[] = { array_n, n_2, n_3, n_0 };  // 3 elements counted, 1 present
+    assert(!bose_stream_write(ds, miscount, sizeof(miscount)));
+    assert(!decode_bose(new_string_iterator(new_octets(miscount, sizeof(miscount)))));
+    assert(bose_stream_write(ds, buf_0, sizeof(buf_0)));
+    assert(value_equal(b, ((struct bose_stream*)ds)->last));
+    u8 partial[] = { array_n, n_3, n_2, n_1 };  // leave a counted array open
+    assert(bose_stream_write(ds, partial, sizeof(partial)));
+    bose_stream_free(ds);
+
+    u8 buf[128];  // compact JSON and BOSE into caller-supplied buffer
+    ACTOR* sk = new_buffer_sink(buf, sizeof(buf), NULL, NULL);
+    assert(to_JSON_sink(sk, b, JSON_COMPACT, MAX_INT));
+    assert(write_code(sk, '\0'));
+    puts((char*)buf);
+    newline();
+    assert(!to_JSON_sink(sk, b, 1, MAX_INT));  // overflow without flush
+    sink_count(sk) = 0;
+    assert(encode_bose(sk, b));
+    a = new_string_builder(octets);
+    assert(encode_bose(a, b));
+    a = get_string_built(a);
+    assert_eq(sink_count(sk), ((struct cal_value*)a)->data_08);
+    assert(value_equal(b, decode_bose(new_string_iterator(new_octets(buf, sink_count(sk))))));
+    release(sk);
     // re-encode example
     a = new_string_builder(octets);
     if (a) {
@@ -2225,6 +3507,28 @@ test_encode()
         release(sb);
     }
 
+    ACTOR* ab = new_array_builder();  // packed integer array
+    int i;
+    for (i = 0; i < 100; ++i) {
+        assert(array_append(ab, new_int((i & 1) ? ((i * i * i) - 25000) : (i - 50))));  // all sizes, both signs
+    }
+    v = get_array_built(ab);
+    release(ab);
+    sb = new_string_builder(octets);
+    assert(sb && encode_bose(sb, v));
+    s = get_string_built(sb);
+    release(sb);
+    assert_eq(encode_size(v), ((struct cal_value*)s)->data_08);
+    assert(value_equal(v, decode_bose(new_string_iterator(s))));
+    v = array_insert(v, 50, &v_true);  // mixed array uses the general path
+    sb = new_string_builder(octets);
+    assert(sb && encode_bose(sb, v));
+    s = get_string_built(sb);
+    release(sb);
+    assert_eq(encode_size(v), ((struct cal_value*)s)->data_08);
+    assert(value_equal(v, decode_bose(new_string_iterator(s))));
+    to_JSON(v, 0, MAX_INT);
+    newline();
 }
 
 void
@@ -128,6 +128,13 @@ extern void     cal_fail();
  */
 extern int      decode_int(int* result, ACTOR* it);
 extern ACTOR*   decode_bose(ACTOR* it);
+
+#define BOSE_STREAM_ITEMS   0x01  // send top-level array elements as they complete
+#define BOSE_PATH_NONE      ((u32)-1)  // message path for a complete top-level value
+#define BOSE_PATH_FAIL      ((u32)-2)  // message path (with NULL value) for malformed input
+extern ACTOR*   new_bose_stream(ACTOR* cust, u32 flags);
+extern int      bose_stream_write(ACTOR* ds, u8* data, u32 n);  // push decoder
+extern void     bose_stream_free(ACTOR* ds);  // release decoder and any partial value
 extern int      encode_u32(ACTOR* sb, u32 w);
 extern int      encode_int(ACTOR* sb, int n);
 extern int      encode_bose(ACTOR* sb, ACTOR* v);
@@ -137,22 +144,34 @@ extern int      number_compare(ACTOR* a, ACTOR* b);  // MIN_INT = incomparable
 extern int      string_compare(ACTOR* s, ACTOR* t);  // MIN_INT = incomparable
 
 extern ACTOR*   new_string_iterator(ACTOR* s);
+extern ACTOR*   new_string_slice(ACTOR* s, u32 offset, u32 count);  // no copy
 extern u32      read_code(ACTOR* it);  // or EOF
 extern ACTOR*   new_string_builder(u8 prefix);
-extern int      write_code(ACTOR* sb, u32 code);
+extern int      write_code(ACTOR* sb, u32 code);  // sb may be a sink
+extern int      write_octets(ACTOR* sb, const u8* data, u32 n);  // bulk write_code()
+
+typedef int (*octet_flush)(void* ctx, const u8* data, int n);  /* < 0 to abort */
+extern ACTOR*   new_buffer_sink(u8* buf, u32 size, octet_flush flush, void* ctx);
+extern int      sink_flush(ACTOR* sk);
 
 extern ACTOR*   new_array();
 extern ACTOR*   array_insert(ACTOR* a, u32 index, ACTOR* element);
 extern ACTOR*   array_element(ACTOR* a, u32 index);
+extern ACTOR*   new_array_builder();
+extern int      array_append(ACTOR* ab, ACTOR* element);  // O(1), no copy
 
 extern ACTOR*   new_object();
 extern ACTOR*   object_set(ACTOR* o, ACTOR* name, ACTOR* value);
 extern ACTOR*   object_get(ACTOR* o, ACTOR* name);
+extern ACTOR*   new_object_builder();
+extern int      object_append(ACTOR* ob, ACTOR* name, ACTOR* value);  // replaces duplicate name
 
 extern ACTOR*   new_collection_iterator(ACTOR* c);
 extern ACTOR*   read_item(ACTOR* it);  // or NULL
 
 extern int      to_JSON(ACTOR* a, int indent, int limit);
+extern int      to_JSON_sink(ACTOR* sk, ACTOR* a, int indent, int limit);
+#define JSON_COMPACT (-1)  // indent for output without whitespace
 
 #define value_prefix(v)             (((struct cal_value*)(v))->byte_05)
 #define number_int(n)               ((int)(((struct cal_value*)(n))->data_08))
@@ -160,6 +179,9 @@ extern int      to_JSON(ACTOR* a, int indent, int limit);
 #define number_base(n)              ((int)(((struct cal_value*)(n))->data_10))
 #define new_literal(c_str)          (new_octets((u8*)(c_str), (u32)(sizeof(c_str) - 1)))
 #define get_string_built(sb)        ((ACTOR*)(((struct cal_stream*)(sb))->data_04))
+#define get_array_built(ab)         ((ACTOR*)(((struct cal_stream*)(ab))->data_04))
+#define get_object_built(ob)        ((ACTOR*)(((struct cal_stream*)(ob))->data_04))
+#define sink_count(sk)              (((struct cal_value*)(sk))->data_08)
 #define array_element_count(a)      (((struct cal_value*)(a))->data_08 >> 2)
 #define object_property_count(o)    (((struct cal_value*)(o))->data_08 >> 3)
 
@@ -38,14 +38,13 @@ a_poll:			@ poll for serial i/o ()
 	.align 5		@ align to cache-line
 	.global a_in_ready
 a_in_ready:		@ check for serial input (ok, fail)
+	bl	serial_in_ready	@ input buffered?
+	teq	r0, #0		@ if ready
+	ldrne	r4, [fp, #0x04]	@	notify ok customer
+	ldreq	r4, [fp, #0x08]	@ otherwise, notify fail customer
 	bl	reserve		@ allocate event block
-	ldr	r2, [ip, #0x1c]	@ UART0
-	ldr	r3, [r2, #0x18]	@ UART0->FR
-	tst	r3, #0x10	@ FR.RXFE
-	ldreq	r1, [fp, #0x04]	@ if ready, notify ok customer
-	ldrne	r1, [fp, #0x08]	@ otherwise, notify fail customer
+	mov	r1, r4		@ target
 	b	_a_send		@ send message
-	.int	0x20201000	@ 0x1c: UART0 base address
 
 	.text
 	.align 5		@ align to cache-line
@@ -64,14 +63,11 @@ a_do_in:		@ request input ()
 	.align 5		@ align to cache-line
 	.global a_char_in
 a_char_in:		@ read serial input (cust)
+	bl	serial_in	@ buffered character
+	mov	r4, r0		@ save character
 	bl	reserve		@ allocate event block
-	ldr	r2, [ip, #0x1c]	@ UART0
-	ldr	r1, [r2]	@ UART0->DR
+	mov	r1, r4		@ answer
 	b	_a_answer	@ answer and return
-	.int	0		@ 0x10: --
-	.int	0		@ 0x14: --
-	.int	0		@ 0x18: --
-	.int	0x20201000	@ 0x1c: UART0 base address
 
 	.text
 	.align 5		@ align to cache-line
@@ -90,11 +86,56 @@ a_do_out:		@ request output (char)
 	.align 5		@ align to cache-line
 	.global a_char_out
 a_char_out:		@ write serial output (cust, char)
-	ldr	r1, [fp, #0x08]	@ character
-	ldr	r2, [ip, #0x1c]	@ UART0
-	str	r1, [r2]	@ UART0->DR
+	ldr	r0, [fp, #0x08]	@ character
+	bl	serial_write	@ buffered output
 	bl	reserve		@ allocate event block
 	b	_a_reply	@ reply and return
-	.int	0		@ 0x14: --
-	.int	0		@ 0x18: --
-	.int	0x20201000	@ 0x1c: UART0 base address
+
+	.data
+	.align 2
+	.global serial_rx_to
+serial_rx_to:		@ registered serial input listener (or 0)
+	.int	0
+
+	.text
+	.align 5		@ align to cache-line
+	.global a_serial_rx
+a_serial_rx:		@ deliver buffered serial input as (char) events ()
+	ldr	r4, =serial_rx_to
+	ldr	r4, [r4]	@ registered listener
+	teq	r4, #0		@ if none
+	beq	complete	@	stop delivering input
+	bl	serial_in_ready	@ input buffered?
+	teq	r0, #0		@ if not ready
+	beq	1f		@	wait for input
+	bl	serial_in	@ get character
+	mov	r1, r0		@ message
+	mov	r0, r4		@ target
+	bl	send_1		@ send (char) to listener
+	ldr	r0, =a_serial_rx @ target actor (self)
+	bl	send_0		@ keep draining the rx ring
+	b	complete	@ return to dispatch loop
+1:	ldr	r0, =a_serial_rx @ target actor (self)
+	mov	r1, #0		@ message = ()
+	mov	r2, #0
+	bl	serial_rx_wait	@ resume when input arrives
+	b	complete	@ return to dispatch loop
+
+	.text
+	.align 5		@ align to cache-line
+	.global a_console_echo
+a_console_echo:		@ echo console input using a_serial_rx ()
+	ldr	r0, =serial_rx_to
+	ldr	r1, =a_char_echo
+	str	r1, [r0]	@ register listener
+	ldr	r0, =a_serial_rx
+	bl	send_0		@ start input delivery
+	b	complete	@ return to dispatch loop
+
+	.text
+	.align 5		@ align to cache-line
+	.global a_char_echo
+a_char_echo:		@ echo character to serial output (char)
+	ldr	r0, [fp, #0x04]	@ character
+	bl	serial_write	@ buffered output
+	b	complete	@ return to dispatch loop
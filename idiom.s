@@ -81,6 +81,10 @@ a_fork:			@ initiate two concurrent events
 	bl	_fork_0		@ create tag actor
 	str	r8, [ip, #0x10] @ remember second tag actor
 
+	mov	r0, r5		@ join is ready, so...
+	bl	enqueue		@ add event_0 to queue
+	mov	r0, r6
+	bl	enqueue		@ add event_1 to queue
 	b	complete	@ return to dispatch loop
 
 _fork_0:		@ create tag actor
@@ -91,8 +95,6 @@ _fork_0:		@ create tag actor
 	bl	create_1	@ create b_tag actor
 	mov	r8, r0		@ remember tag actor
 	str	r8, [r7, #0x04]	@ set/replace customer in event_n
-	mov	r0, r7
-	bl	enqueue		@ add event to queue
 	ldmia	sp!, {pc}	@ restore in-use registers and return
 
 @
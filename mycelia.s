@@ -86,16 +86,28 @@ trace_event:		@ invoke event tracing hook, if present
 	teq	r1, #0		@ if disabled
 	bxeq	lr		@	return
 	stmdb	sp!, {lr}	@ preserve in-use registers
-	bx	r1		@ call trace procedure (r0=event)
+	blx	r1		@ call trace procedure (r0=event)
 	ldmia	sp!, {pc}	@ restore in-use registers and return
 	.data
 	.align 2		@ align to machine word
 trace_to:
 	.int 0			@ tracing procedure address, or 0 for none
 
+	.text
+	.align 2		@ align to machine word
+irq_check:		@ deliver events posted by interrupt handlers, if any
+	ldr	r0, =irq_due	@ interrupt work flag address
+	ldr	r0, [r0]	@ get work flag
+	teq	r0, #0		@ if nothing posted
+	bxeq	lr		@	return
+	b	irq_events	@ deliver posted events (returns to caller)
+
 	.text
 	.align 2		@ align to machine word
 watchdog_check:		@ check for timeout
+	stmdb	sp!, {lr}	@ preserve link register
+	bl	irq_check	@ deliver interrupt events, if any
+	ldmia	sp!, {lr}	@ restore link register
 	ldr	r2, =watchdog_a	@ watchdog actor address
 	ldr	r0, [r2]	@ get watchdog actor
 	teq	r0, #0		@ if disabled
@@ -147,9 +159,20 @@ watchdog_t:
 	.align 2		@ align to machine word
 	.global exit
 exit:			@ exit the actor kernel
+	ldr	r0, =smp_run	@ location of SMP run flag
+	mov	r1, #0		@ 0 stops SMP dispatch
+	str	r1, [r0]	@ stop other cores, if running
+	ldr	r0, =sponsor_3	@ SMP sponsor for core 0
+	sub	r0, sl, r0	@ offset from core 0 sponsor
+	cmp	r0, #0x40	@ if offset in [0x40, 0x100)
+	blo	1f
+	cmp	r0, #0x100
+	blo	smp_entry	@	park secondary core
+1:
 	ldr	r0, =exit_sp	@ location of exit stack pointer
 	ldr	sp, [r0]	@ get stack pointer saved on entry
 	ldmia	sp!, {r4-ip,pc}	@ restore registers and return
+	.ltorg			@ literal pool within reach of the code above
 
 	.data
 	.align 2		@ align to machine word
@@ -161,14 +184,21 @@ exit_sp:
 event_q:
 	.space 256*4		@ event queue (offset 0)
 	.int 0			@ queue head/tail (offset 1024)
+	.int 0			@ spill chain read pointer (offset 1028)
+	.int 0			@ spill chain write pointer (offset 1032)
 
 	.data
 @	.align 2		@ align to machine word
 	.align 5		@ align to cache-line
 block_free:
 	.int 0			@ pointer to next free block, 0 if none
+	.global block_end
 block_end:
 	.int heap_start		@ pointer to end of block memory
+block_free_n:
+	.int 0			@ pointer to next free 64-byte block, 0 if none
+	.int 0			@ pointer to next free 128-byte block, 0 if none
+	.int 0			@ pointer to next free 256-byte block, 0 if none
 
 	.section .rodata
 	.align 5		@ align to cache-line
@@ -202,16 +232,113 @@ reserve:		@ reserve a block (32 bytes) of memory
 
 	.global release
 release:		@ release the memory block pointed to by r0
+	mcr	p15, 0, r0, c7, c5, 1 @ invalidate I-cache line (stale actor code)
 	ldr	pc, [sl,#0x0c]	@ jump to sponsor release handler
 
 	.global enqueue
 enqueue:		@ enqueue event pointed to by r0
+	mov	r1, #0		@ zero
+	mcr	p15, 0, r1, c7, c10, 4 @ drain write buffer (new actor code to memory)
 	ldr	pc, [sl,#0x10]	@ jump to sponsor enqueue handler
 
 	.global dequeue
 dequeue:		@ dequeue next event from queue
 	ldr	pc, [sl,#0x14]	@ jump to sponsor dequeue handler
 
+	.global reserve_n
+reserve_n:		@ reserve a block of r0 bytes (32, 64, 128 or 256)
+	ldr	pc, [sl,#0x20]	@ jump to sponsor sized-reserve handler
+
+	.global release_n
+release_n:		@ release the memory block r0 of r1 bytes
+	mov	r2, r0		@ first cache line of block
+	add	r3, r0, r1	@ end of block
+1:
+	mcr	p15, 0, r2, c7, c5, 1 @ invalidate I-cache line (stale actor code)
+	add	r2, r2, #32	@ advance to next cache line
+	cmp	r2, r3		@ if not past end of block
+	blo	1b		@	invalidate next line
+	ldr	pc, [sl,#0x24]	@ jump to sponsor sized-release handler
+
+@
+@ Memory is carved from block_end a page (4kB) at a time, and handed out
+@ in size classes of 32, 64, 128 and 256 bytes, each with its own free list.
+@ 32-byte blocks come from the sponsor's own reserve/release handlers.
+@
+	.text
+	.align 2		@ align to machine word
+carve:			@ carve a page of new blocks onto an empty free list
+			@ (r0=block size, r1=free list pointer)
+	stmdb	sp!, {r4-r5,lr}	@ preserve in-use registers
+	ldr	r2, =block_end	@ address of block end pointer
+1:
+	ldrex	r3, [r2]	@ address of new page (exclusive)
+	add	r4, r3, #0x1000	@ calculate end of page
+	strex	r5, r4, [r2]	@ try to update block end pointer
+	teq	r5, #0		@ if another core got there first
+	bne	1b		@	try again
+	str	r3, [r1]	@ free list starts at first block
+	sub	r4, r4, r0	@ address of last block
+2:
+	add	r5, r3, r0	@ address of next block
+	str	r5, [r3]	@ link block to next block
+	mov	r3, r5		@ advance to next block
+	cmp	r3, r4		@ if not last block
+	blo	2b		@	keep linking
+	mov	r5, #0		@ null pointer
+	str	r5, [r3]	@ last block ends free list
+	ldmia	sp!, {r4-r5,pc}	@ restore in-use registers and return
+
+reserve_n_0:		@ reserve a block of r0 bytes (up to 256)
+	ldr	r1, =block_free_n @ shared size-class free lists
+_reserve_n:		@ (r0=size, r1=free lists for 64, 128 and 256 bytes)
+	cmp	r0, #32		@ if size <= 32
+	bls	reserve		@	reserve from sponsor
+	cmp	r0, #256	@ if size > 256
+	movhi	r0, #0		@	fail!
+	bxhi	lr		@	return null
+	mov	r2, #64		@ size class 64
+	cmp	r0, #64
+	bls	1f
+	add	r1, r1, #4	@ free list for size class 128
+	mov	r2, #128
+	cmp	r0, #128
+	bls	1f
+	add	r1, r1, #4	@ free list for size class 256
+	mov	r2, #256
+1:
+	ldr	r0, [r1]	@ address of first free block
+	teq	r0, #0
+	beq	2f		@ if not null
+	ldr	r3, [r0]	@	follow link to next free block
+	str	r3, [r1]	@	update free list pointer
+	mov	r3, #0		@	null pointer
+	str	r3, [r0]	@	set link to null
+	bx	lr		@	return
+2:				@ else
+	stmdb	sp!, {r1,lr}	@	preserve free list pointer
+	mov	r0, r2		@	block size
+	bl	carve		@	carve a page of new blocks
+	ldmia	sp!, {r1,lr}	@	restore free list pointer
+	b	1b		@	try again
+
+release_n_0:		@ release block r0 of r1 bytes
+	ldr	r2, =block_free_n @ shared size-class free lists
+_release_n:		@ (r0=block, r1=size, r2=free lists for 64, 128 and 256 bytes)
+	cmp	r1, #32		@ if size <= 32
+	bls	release		@	release to sponsor
+	cmp	r1, #64
+	bls	1f
+	add	r2, r2, #4	@ free list for size class 128
+	cmp	r1, #128
+	addhi	r2, r2, #4	@ free list for size class 256
+1:
+	ldr	r3, [r2]	@ address of next free block
+	str	r3, [r0]	@ link block into free list
+	str	r0, [r2]	@ update free list pointer
+	bx	lr		@ return
+	.ltorg			@ literal pool within reach of the code above
+
 @
 @ The default sponsor supports optional tracing and watchdog features
 @
@@ -227,6 +354,11 @@ sponsor_0:
 	.int	dequeue_0	@ 0x14: dequeue next event, or 0
 	.int	0		@ 0x18: --
 	.int	0		@ 0x1c: current event
+	.int	reserve_n_0	@ 0x20: reserve memory block (r0=size, up to 256 bytes)
+	.int	release_n_0	@ 0x24: release memory block (r0=block, r1=size)
+	.int	0		@ 0x28: poison sample mask (0=every block, -1=never)
+	.int	0		@ 0x2c: count of released blocks poisoned
+	.int	0		@ 0x30: count of released blocks not poisoned
 
 	.text
 	.align 2		@ align to machine word
@@ -260,35 +392,53 @@ reserve_0:		@ reserve a block (32 bytes) of memory
 	str	r3, [r0]	@	set link to null
 	ldmia	sp!, {pc}	@	return
 1:				@ else
-	ldr	r1, =block_end	@	address of block end pointer
-	ldr	r0, [r1]	@	address of new memory block
-	add	r2, r0, #32	@	calculate next block address
-	str	r2, [r1]	@	update block end pointer
-	bl	release_0	@	"free" new memory block
+	mov	r0, #32		@	block size
+	ldr	r1, =block_free	@	address of free list pointer
+	bl	carve		@	carve a page of new blocks
 	ldmia	sp!, {lr}	@	restore link register
 	b	reserve_0	@	try again
 
 release_0:		@ release the memory block pointed to by r0
 			@ [FIXME] add sanity check(s), r0 must be in heap
-	stmdb	sp!, {r4-r9,lr}	@ preserve in-use registers
 	ldr	r1, =block_free	@ address of free list pointer
 	ldr	r2, [r1]	@ address of next free block
 	str	r0, [r1]	@ update free list pointer
+	str	r2, [r0]	@ link block into free list
+	ldr	r3, [sl, #0x28]	@ get poison sample mask
+	cmn	r3, #1		@ if poisoning disabled
+	beq	1f		@	skip block-erase
+	ldr	r1, [sl, #0x2c]	@ get count of blocks poisoned
+	ldr	r2, [sl, #0x30]	@ get count of blocks not poisoned
+	add	r2, r1, r2	@ count of blocks released
+	tst	r2, r3		@ if block not sampled
+	bne	1f		@	skip block-erase
+	add	r1, r1, #1	@ increment count
+	str	r1, [sl, #0x2c]	@ update count of blocks poisoned
+	stmdb	sp!, {r4-r9,lr}	@ preserve in-use registers
 	ldr	r1, =block_clr	@ address of block-erase pattern
 	ldmia	r1, {r3-r9}	@ read 7 words (32 - 4 bytes)
-	stmia	r0, {r2-r9}	@ write 8 words (incl. next free block pointer)
+	stmib	r0, {r3-r9}	@ write 7 words (after next free block pointer)
 	ldmia	sp!, {r4-r9,pc}	@ restore in-use registers and return
+1:
+	ldr	r1, [sl, #0x30]	@ get count of blocks not poisoned
+	add	r1, r1, #1	@ increment count
+	str	r1, [sl, #0x30]	@ update count of blocks not poisoned
+	bx	lr		@ return
 
 enqueue_0:		@ enqueue event pointed to by r0
 			@ [FIXME] add sanity check(s), r0 must be in heap
 	ldr	r1, =event_q	@ get event queue pointer
+	ldr	r3, [r1, #1032]	@ spill chain write pointer
+	teq	r3, #0		@ if spilling
+	bne	spill_q		@	keep FIFO order, add to chain
 	ldr	r3, [r1, #1024]	@ event queue head/tail indicies
 	uxtb	r2, r3, ROR #8	@ get head index
 	uxtb	r3, r3, ROR #16	@ get tail index
 	str	r0, [r1,r3,LSL #2] @ store event pointer at tail
 	add	r3, r3, #1	@ advance tail
+	and	r3, r3, #0xFF	@ wrap around 256 entries
 	cmp	r2, r3		@ if queue full
-	beq	panic		@	kernel panic!
+	beq	spill_q		@	add event to spill chain
 	strb	r3, [r1, #1026]	@ update tail index
 	bx	lr		@ return
 
@@ -298,11 +448,71 @@ dequeue_0:		@ dequeue next event from queue
 	uxtb	r2, r3, ROR #8	@ get head index
 	uxtb	r3, r3, ROR #16	@ get tail index
 	cmp	r2, r3		@ if queue empty
+	beq	unspill_q	@	try spill chain
+	ldr	r0, [r1,r2,LSL #2] @ get event pointer at head
+	add	r2, r2, #1	@ advance head
+	strb	r2, [r1, #1025]	@ update head index
+	bx	lr		@ return event pointer
+
+@
+@ When the event_q ring is full, events spill into a chain of blocks,
+@ each holding 7 event pointers and a link to the next block (at 0x1c).
+@ Once spilling starts, new events go to the chain until it drains,
+@ and the chain is only read when the ring is empty, which keeps FIFO order.
+@
+	.text
+	.align 2		@ align to machine word
+spill_q:		@ add event to spill chain
+			@ (r0=event, r1=event queue, chain pointers at 1028 and 1032)
+	ldr	r3, [r1, #1032]	@ get chain write pointer
+	teq	r3, #0		@ if no chain
+	beq	1f		@	allocate first block
+	and	r2, r3, #0x1F	@ offset within chain block
+	teq	r2, #0x1C	@ if at link, block is full
+	beq	1f		@	allocate next block
+	str	r0, [r3], #4	@ store event, advance write pointer
+	str	r3, [r1, #1032]	@ update chain write pointer
+	bx	lr		@ return
+1:
+	stmdb	sp!, {r0,r1,r3,lr} @ preserve event, queue and write pointer
+	bl	reserve		@ allocate chain block
+	ldmia	sp!, {r1,r2,r3,lr} @ restore event (r1), queue (r2) and write pointer
+	teq	r3, #0		@ if no chain
+	streq	r0, [r2, #1028]	@	start reading at new block
+	strne	r0, [r3]	@ else link new block into chain
+	str	r1, [r0], #4	@ store event, advance write pointer
+	str	r0, [r2, #1032]	@ update chain write pointer
+	bx	lr		@ return
+
+unspill_q:		@ remove event from spill chain, or 0
+			@ (r1=event queue)
+	ldr	r2, [r1, #1028]	@ get chain read pointer
+	ldr	r3, [r1, #1032]	@ get chain write pointer
+	teq	r2, r3		@ if chain empty
 	moveq	r0, #0		@	return null
-	ldrne	r0, [r1,r2,LSL #2] @ else
-	addne	r2, r2, #1	@	advance head
-	strneb	r2, [r1, #1025]	@	update head index
-	bx	lr		@	return event pointer
+	bxeq	lr
+	ldr	r0, [r2], #4	@ get event, advance read pointer
+	teq	r2, r3		@ if chain drained
+	beq	2f		@	release last block
+	and	r3, r2, #0x1F	@ offset within chain block
+	teq	r3, #0x1C	@ if not at link
+	strne	r2, [r1, #1028]	@	update chain read pointer
+	bxne	lr		@	return event pointer
+	stmdb	sp!, {r0,lr}	@ preserve event
+	ldr	r3, [r2]	@ follow link to next chain block
+	str	r3, [r1, #1028]	@ update chain read pointer
+	sub	r0, r2, #0x1C	@ address of exhausted block
+	bl	release		@ free exhausted block
+	ldmia	sp!, {r0,pc}	@ restore event and return
+2:
+	mov	r3, #0		@ null pointer
+	str	r3, [r1, #1028]	@ clear chain read pointer
+	str	r3, [r1, #1032]	@ clear chain write pointer (stop spilling)
+	stmdb	sp!, {r0,lr}	@ preserve event
+	sub	r0, r2, #4	@ address of last slot read
+	bic	r0, r0, #0x1F	@ address of last block
+	bl	release		@ free last block
+	ldmia	sp!, {r0,pc}	@ restore event and return
 
 @
 @ The fast sponsor supports does not support tracing or watchdog features
@@ -317,8 +527,10 @@ sponsor_1:
 	.int	release_1	@ 0x0c: release memory block (r0)
 	.int	enqueue_1	@ 0x10: enqueue event (r0)
 	.int	dequeue_1	@ 0x14: dequeue next event, or 0
-	.int	0		@ 0x18: --
+	.int	0		@ 0x18: count of events dispatched (BENCH builds only)
 	.int	0		@ 0x1c: --
+	.int	reserve_n_0	@ 0x20: reserve memory block (r0=size, up to 256 bytes)
+	.int	release_n_0	@ 0x24: release memory block (r0=block, r1=size)
 
 	.text
 	.align 2		@ align to machine word
@@ -328,11 +540,17 @@ complete_1:		@ completion of event pointed to by fp
 	mov	fp, #0		@ clear frame pointer
 	@ WARNING! complete falls through to dispatch...
 dispatch_1:		@ dispatch next event
+	bl	irq_check	@ deliver interrupt events, if any
 	bl	dequeue_1	@ try to get next event
 	teq	r0, #0		@ check for null
 	beq	dispatch_1	@ if no event, try again...
 
 	mov	fp, r0		@ initialize frame pointer
+	.ifdef BENCH	@ dispatch count for the benchmark suite
+	ldr	r1, [sl, #0x18]	@ get count of events dispatched
+	add	r1, r1, #1	@ increment count
+	str	r1, [sl, #0x18]	@ update count of events dispatched
+	.endif
 	ldr	ip, [fp]	@ get target actor address
 	bx	ip		@ jump to actor behavior
 
@@ -348,11 +566,9 @@ reserve_1:		@ reserve a block (32 bytes) of memory
 	bx	lr		@	return
 1:				@ else
 	stmdb	sp!, {lr}	@	preserve link register
-	ldr	r1, =block_end	@	address of block end pointer
-	ldr	r0, [r1]	@	address of new memory block
-	add	r2, r0, #32	@	calculate next block address
-	str	r2, [r1]	@	update block end pointer
-	bl	release_1	@	"free" new memory block
+	mov	r0, #32		@	block size
+	ldr	r1, =block_free	@	address of free list pointer
+	bl	carve		@	carve a page of new blocks
 	ldmia	sp!, {lr}	@	restore link register
 	b	reserve_1	@	try again
 
@@ -365,13 +581,17 @@ release_1:		@ release the memory block pointed to by r0
 
 enqueue_1:		@ enqueue event pointed to by r0
 	ldr	r1, =event_q	@ get event queue pointer
+	ldr	r3, [r1, #1032]	@ spill chain write pointer
+	teq	r3, #0		@ if spilling
+	bne	spill_q		@	keep FIFO order, add to chain
 	ldr	r3, [r1, #1024]	@ event queue head/tail indicies
 	uxtb	r2, r3, ROR #8	@ get head index
 	uxtb	r3, r3, ROR #16	@ get tail index
 	str	r0, [r1,r3,LSL #2] @ store event pointer at tail
 	add	r3, r3, #1	@ advance tail
+	and	r3, r3, #0xFF	@ wrap around 256 entries
 	teq	r2, r3		@ if queue full
-	beq	panic		@	kernel panic!
+	beq	spill_q		@	add event to spill chain
 	strb	r3, [r1, #1026]	@ update tail index
 	bx	lr		@ return
 
@@ -381,11 +601,11 @@ dequeue_1:		@ dequeue next event from queue
 	uxtb	r2, r3, ROR #8	@ get head index
 	uxtb	r3, r3, ROR #16	@ get tail index
 	teq	r2, r3		@ if queue empty
-	moveq	r0, #0		@	return null
-	ldrne	r0, [r1,r2,LSL #2] @ else
-	addne	r2, r2, #1	@	advance head
-	strneb	r2, [r1, #1025]	@	update head index
-	bx	lr		@	return event pointer
+	beq	unspill_q	@	try spill chain
+	ldr	r0, [r1,r2,LSL #2] @ get event pointer at head
+	add	r2, r2, #1	@ advance head
+	strb	r2, [r1, #1025]	@ update head index
+	bx	lr		@ return event pointer
 
 @
 @ The debug sponsor doesn't release event memory, otherwise acts like default
@@ -402,6 +622,11 @@ sponsor_2:
 	.int	dequeue_0	@ 0x14: dequeue next event, or 0
 	.int	0		@ 0x18: --
 	.int	0		@ 0x1c: current event
+	.int	reserve_n_0	@ 0x20: reserve memory block (r0=size, up to 256 bytes)
+	.int	release_n_0	@ 0x24: release memory block (r0=block, r1=size)
+	.int	0		@ 0x28: poison sample mask (0=every block, -1=never)
+	.int	0		@ 0x2c: count of released blocks poisoned
+	.int	0		@ 0x30: count of released blocks not poisoned
 
 	.text
 	.align 2		@ align to machine word
@@ -423,6 +648,714 @@ dispatch_2:		@ dispatch next event
 	ldr	ip, [fp]	@ get target actor address
 	bx	ip		@ jump to actor behavior
 
+@
+@ The SMP sponsor gives each core its own dispatch loop, event queue and
+@ free list, but does not support tracing or watchdog features.
+@ An idle core steals events from other cores' queues (using LDREX/STREX),
+@ and an actor is never dispatched on two cores at the same time.
+@ A full ring spills into a per-core chain (see spill_q), which only
+@ its own core reads, so other cores steal only from the ring.
+@
+	.data
+	.align 5		@ align to cache-line
+	.global sponsor_3
+sponsor_3:		@ per-core sponsor tables (64 bytes each)
+	.int	dispatch_3	@ 0x00: dispatch the next event (ip=actor, fp=event)
+	.int	complete_3	@ 0x04: complete event dispatch (fp=event)
+	.int	reserve_3	@ 0x08: reserve memory block (32 bytes)
+	.int	release_3	@ 0x0c: release memory block (r0)
+	.int	enqueue_3	@ 0x10: enqueue event (r0)
+	.int	dequeue_3	@ 0x14: dequeue next event, or 0
+	.int	0		@ 0x18: claimed actor, or 0 for none
+	.int	0		@ 0x1c: current event
+	.int	reserve_n_3	@ 0x20: reserve memory block (r0=size, up to 256 bytes)
+	.int	release_n_3	@ 0x24: release memory block (r0=block, r1=size)
+	.int	0		@ 0x28: per-core free list (32 bytes)
+	.int	0		@ 0x2c: per-core free list (64 bytes)
+	.int	0		@ 0x30: per-core free list (128 bytes)
+	.int	0		@ 0x34: per-core free list (256 bytes)
+	.int	smp_q_0		@ 0x38: per-core event queue
+	.int	0		@ 0x3c: count of events stolen from other cores
+
+	.int	dispatch_3	@ 0x00: dispatch the next event (ip=actor, fp=event)
+	.int	complete_3	@ 0x04: complete event dispatch (fp=event)
+	.int	reserve_3	@ 0x08: reserve memory block (32 bytes)
+	.int	release_3	@ 0x0c: release memory block (r0)
+	.int	enqueue_3	@ 0x10: enqueue event (r0)
+	.int	dequeue_3	@ 0x14: dequeue next event, or 0
+	.int	0		@ 0x18: claimed actor, or 0 for none
+	.int	0		@ 0x1c: current event
+	.int	reserve_n_3	@ 0x20: reserve memory block (r0=size, up to 256 bytes)
+	.int	release_n_3	@ 0x24: release memory block (r0=block, r1=size)
+	.int	0		@ 0x28: per-core free list (32 bytes)
+	.int	0		@ 0x2c: per-core free list (64 bytes)
+	.int	0		@ 0x30: per-core free list (128 bytes)
+	.int	0		@ 0x34: per-core free list (256 bytes)
+	.int	smp_q_1		@ 0x38: per-core event queue
+	.int	0		@ 0x3c: count of events stolen from other cores
+
+	.int	dispatch_3	@ 0x00: dispatch the next event (ip=actor, fp=event)
+	.int	complete_3	@ 0x04: complete event dispatch (fp=event)
+	.int	reserve_3	@ 0x08: reserve memory block (32 bytes)
+	.int	release_3	@ 0x0c: release memory block (r0)
+	.int	enqueue_3	@ 0x10: enqueue event (r0)
+	.int	dequeue_3	@ 0x14: dequeue next event, or 0
+	.int	0		@ 0x18: claimed actor, or 0 for none
+	.int	0		@ 0x1c: current event
+	.int	reserve_n_3	@ 0x20: reserve memory block (r0=size, up to 256 bytes)
+	.int	release_n_3	@ 0x24: release memory block (r0=block, r1=size)
+	.int	0		@ 0x28: per-core free list (32 bytes)
+	.int	0		@ 0x2c: per-core free list (64 bytes)
+	.int	0		@ 0x30: per-core free list (128 bytes)
+	.int	0		@ 0x34: per-core free list (256 bytes)
+	.int	smp_q_2		@ 0x38: per-core event queue
+	.int	0		@ 0x3c: count of events stolen from other cores
+
+	.int	dispatch_3	@ 0x00: dispatch the next event (ip=actor, fp=event)
+	.int	complete_3	@ 0x04: complete event dispatch (fp=event)
+	.int	reserve_3	@ 0x08: reserve memory block (32 bytes)
+	.int	release_3	@ 0x0c: release memory block (r0)
+	.int	enqueue_3	@ 0x10: enqueue event (r0)
+	.int	dequeue_3	@ 0x14: dequeue next event, or 0
+	.int	0		@ 0x18: claimed actor, or 0 for none
+	.int	0		@ 0x1c: current event
+	.int	reserve_n_3	@ 0x20: reserve memory block (r0=size, up to 256 bytes)
+	.int	release_n_3	@ 0x24: release memory block (r0=block, r1=size)
+	.int	0		@ 0x28: per-core free list (32 bytes)
+	.int	0		@ 0x2c: per-core free list (64 bytes)
+	.int	0		@ 0x30: per-core free list (128 bytes)
+	.int	0		@ 0x34: per-core free list (256 bytes)
+	.int	smp_q_3		@ 0x38: per-core event queue
+	.int	0		@ 0x3c: count of events stolen from other cores
+
+	.data
+	.align 2		@ align to machine word
+smp_run:
+	.int 0			@ SMP dispatch enabled, or 0 to stop
+
+	.section .bss
+	.align 5		@ align to cache-line
+smp_q_0:
+	.space 256*4		@ event queue for core 0 (offset 0)
+	.int 0			@ queue head index (offset 1024)
+	.int 0			@ spill chain read pointer (offset 1028)
+	.int 0			@ spill chain write pointer (offset 1032)
+	.int 0			@ queue tail index (offset 1036)
+	.align 5		@ align to cache-line
+smp_q_1:
+	.space 256*4		@ event queue for core 1 (offset 0)
+	.int 0			@ queue head index (offset 1024)
+	.int 0			@ spill chain read pointer (offset 1028)
+	.int 0			@ spill chain write pointer (offset 1032)
+	.int 0			@ queue tail index (offset 1036)
+	.align 5		@ align to cache-line
+smp_q_2:
+	.space 256*4		@ event queue for core 2 (offset 0)
+	.int 0			@ queue head index (offset 1024)
+	.int 0			@ spill chain read pointer (offset 1028)
+	.int 0			@ spill chain write pointer (offset 1032)
+	.int 0			@ queue tail index (offset 1036)
+	.align 5		@ align to cache-line
+smp_q_3:
+	.space 256*4		@ event queue for core 3 (offset 0)
+	.int 0			@ queue head index (offset 1024)
+	.int 0			@ spill chain read pointer (offset 1028)
+	.int 0			@ spill chain write pointer (offset 1032)
+	.int 0			@ queue tail index (offset 1036)
+
+	.text
+	.align 2		@ align to machine word
+	.global smp_start
+smp_start:		@ reset per-core state and release SMP dispatch
+	ldr	r0, =sponsor_3	@ base of per-core sponsor tables
+	add	r1, r0, #0x100	@ end of per-core sponsor tables
+	mov	r2, #0		@ zero
+1:
+	str	r2, [r0, #0x1c]	@ clear current event
+	str	r2, [r0, #0x3c]	@ clear steal count
+	str	r2, [r0, #0x18]	@ clear claimed actor
+	ldr	r3, [r0, #0x38]	@ get event queue
+	str	r2, [r3, #1024]	@ clear head index
+	str	r2, [r3, #1028]	@ clear spill chain read pointer
+	str	r2, [r3, #1032]	@ clear spill chain write pointer
+	str	r2, [r3, #1036]	@ clear tail index
+	add	r0, r0, #0x40	@ next core
+	cmp	r0, r1		@ if more cores
+	blo	1b		@	reset next core
+	mcr	p15, 0, r2, c7, c10, 5 @ data memory barrier (reset before run)
+	ldr	r0, =smp_run	@ location of SMP run flag
+	mov	r1, #1		@ 1 enables SMP dispatch
+	str	r1, [r0]	@ release waiting cores
+	bx	lr		@ return
+
+	.text
+	.align 2		@ align to machine word
+	.global smp_core
+smp_core:		@ secondary core waits for SMP dispatch
+			@ (r0=core number)
+	ldr	sl, =sponsor_3	@ base of per-core sponsor tables
+	add	sl, sl, r0, LSL #6 @ sponsor table for this core
+	mov	fp, #0		@ no current event
+	ldr	r1, =smp_run	@ location of SMP run flag
+1:
+	ldr	r0, [r1]	@ get run flag
+	teq	r0, #0		@ if stopped
+	beq	1b		@	keep waiting
+	b	dispatch_3	@ join dispatch loop
+
+	.text
+	.align 2		@ align to machine word
+complete_3:		@ completion of event pointed to by fp
+	mov	r0, fp		@ get completed event
+	bl	release_3	@ free completed event
+	mov	fp, #0		@ clear frame pointer
+	str	fp, [sl, #0x1c]	@ clear current event
+	mcr	p15, 0, fp, c7, c10, 5 @ data memory barrier (actor updates before release)
+	str	fp, [sl, #0x18]	@ release claimed actor
+	@ WARNING! complete falls through to dispatch...
+dispatch_3:		@ dispatch next event
+	ldr	r0, =smp_run	@ location of SMP run flag
+	ldr	r0, [r0]	@ get run flag
+	teq	r0, #0		@ if stopped
+	beq	exit		@	exit (or park secondary core)
+	ldr	r0, =sponsor_3	@ sponsor table for core 0
+	teq	r0, sl		@ if on core 0 (which takes interrupts)
+	bleq	irq_check	@	deliver interrupt events, if any
+	bl	dequeue_3	@ try to get next local event
+	teq	r0, #0		@ if no local event
+	bleq	steal_3		@	try to steal from another core
+	teq	r0, #0		@ check for null
+	beq	dispatch_3	@ if no event, try again...
+
+	mov	fp, r0		@ initialize frame pointer
+	bl	claim_3		@ claim target actor for this core
+	teq	r0, #0		@ if target busy on another core
+	beq	1f		@	defer event
+	str	fp, [sl, #0x1c]	@ update current event
+	ldr	ip, [fp]	@ get target actor address
+	bx	ip		@ jump to actor behavior
+1:
+	mov	r0, fp		@ get deferred event
+	mov	fp, #0		@ clear frame pointer
+	bl	enqueue_3	@ retry event later, on this core
+	b	dispatch_3	@ dispatch something else
+
+claim_3:		@ claim target actor of event fp for this core
+			@ (returns r0=actor, or 0 if busy on another core)
+	ldr	r0, [fp]	@ get target actor address
+	str	r0, [sl, #0x18]	@ publish claim
+	mov	r1, #0		@ zero
+	mcr	p15, 0, r1, c7, c10, 5 @ data memory barrier (claim before check)
+	ldr	r1, =sponsor_3	@ base of per-core sponsor tables
+	add	r2, r1, #0x100	@ end of per-core sponsor tables
+1:
+	cmp	r1, sl		@ if not this core
+	beq	2f
+	ldr	r3, [r1, #0x18]	@	get claim by other core
+	teq	r3, r0		@	if same actor
+	beq	3f		@		target is busy
+2:
+	add	r1, r1, #0x40	@ next core
+	cmp	r1, r2		@ if more cores
+	blo	1b		@	check next core
+	mov	r1, #0		@ zero
+	mcr	p15, 0, r1, c7, c10, 5 @ data memory barrier (claim before actor loads)
+	bx	lr		@ return claimed actor
+3:
+	mov	r0, #0		@ null pointer
+	str	r0, [sl, #0x18]	@ withdraw claim
+	bx	lr		@ return null
+
+reserve_3:		@ reserve a block (32 bytes) of memory
+	ldr	r0, [sl, #0x28]	@ address of first free block on this core
+	mov	r3, #0		@ null pointer
+	teq	r0, r3
+	beq	1f		@ if not null
+	ldr	r2, [r0]	@	follow link to next free block
+	str	r2, [sl, #0x28]	@	update free list pointer
+	str	r3, [r0]	@	set link to null
+	bx	lr		@	return
+1:				@ else
+	stmdb	sp!, {lr}	@	preserve link register
+	mov	r0, #32		@	block size
+	add	r1, sl, #0x28	@	address of free list pointer
+	bl	carve		@	carve a page of new blocks
+	ldmia	sp!, {lr}	@	restore link register
+	b	reserve_3	@	try again
+
+release_3:		@ release the memory block pointed to by r0
+	ldr	r2, [sl, #0x28]	@ address of next free block on this core
+	str	r2, [r0]	@ link block into free list
+	str	r0, [sl, #0x28]	@ update free list pointer
+	bx	lr		@ return
+
+reserve_n_3:		@ reserve a block of r0 bytes (up to 256)
+	add	r1, sl, #0x2c	@ per-core size-class free lists
+	b	_reserve_n	@ reserve from size class
+
+release_n_3:		@ release block r0 of r1 bytes
+	add	r2, sl, #0x2c	@ per-core size-class free lists
+	b	_release_n	@ release to size class
+
+enqueue_3:		@ enqueue event pointed to by r0 (on this core)
+	ldr	r1, [sl, #0x38]	@ get event queue for this core
+	ldr	r3, [r1, #1032]	@ spill chain write pointer
+	teq	r3, #0		@ if spilling
+	bne	spill_q		@	keep FIFO order, add to chain
+	ldr	r3, [r1, #1036]	@ get tail index
+	str	r0, [r1,r3,LSL #2] @ store event pointer at tail
+	add	r3, r3, #1	@ advance tail
+	and	r3, r3, #0xFF	@ wrap around 256 entries
+	ldr	r2, [r1, #1024]	@ get head index
+	teq	r2, r3		@ if queue full
+	beq	spill_q		@	add event to spill chain
+	mov	r2, #0		@ zero
+	mcr	p15, 0, r2, c7, c10, 5 @ data memory barrier (event before tail)
+	str	r3, [r1, #1036]	@ update tail index
+	bx	lr		@ return
+
+dequeue_3:		@ dequeue next event from queue (on this core)
+	stmdb	sp!, {lr}	@ preserve link register
+	ldr	r1, [sl, #0x38]	@ get event queue for this core
+	bl	take_3		@ take event from ring
+	ldmia	sp!, {lr}	@ restore link register
+	teq	r0, #0		@ if we got one
+	bxne	lr		@	return event pointer
+	ldr	r1, [sl, #0x38]	@ get event queue for this core
+	b	unspill_q	@ try spill chain (only read by this core)
+
+take_3:			@ take next event from any core's ring
+			@ (r1=event queue)
+	add	r2, r1, #1024	@ address of head index
+1:
+	ldrex	r3, [r2]	@ get head index (exclusive)
+	ldr	r0, [r2, #12]	@ get tail index
+	teq	r3, r0		@ if queue empty
+	moveq	r0, #0		@	return null
+	bxeq	lr
+	mov	r0, #0		@ zero
+	mcr	p15, 0, r0, c7, c10, 5 @ data memory barrier (tail before event)
+	ldr	r0, [r1,r3,LSL #2] @ get event pointer at head
+	add	r3, r3, #1	@ advance head
+	and	r3, r3, #0xFF	@ wrap around 256 entries
+	strex	r1, r3, [r2]	@ try to update head index
+	teq	r1, #0		@ if another core got there first
+	subne	r1, r2, #1024	@	recover event queue
+	bne	1b		@	try again
+	bx	lr		@ return event pointer
+
+steal_3:		@ steal an event from another core, or 0
+	stmdb	sp!, {r4-r5,lr}	@ preserve in-use registers
+	ldr	r4, =sponsor_3	@ base of per-core sponsor tables
+	sub	r4, sl, r4	@ offset of this core's table
+	mov	r4, r4, LSR #6	@ get this core number
+	mov	r5, #3		@ number of other cores
+1:
+	add	r4, r4, #1	@ next core
+	and	r4, r4, #3	@ wrap around 4 cores
+	ldr	r1, =sponsor_3	@ base of per-core sponsor tables
+	add	r1, r1, r4, LSL #6 @ sponsor table for core
+	ldr	r1, [r1, #0x38]	@ get event queue for core
+	bl	take_3		@ try to take an event
+	teq	r0, #0		@ if we got one
+	bne	2f		@	count it
+	subs	r5, r5, #1	@ if more cores
+	bne	1b		@	try next core
+	ldmia	sp!, {r4-r5,pc}	@ restore in-use registers and return null
+2:
+	ldr	r1, [sl, #0x3c]	@ get count of stolen events
+	add	r1, r1, #1	@ increment count
+	str	r1, [sl, #0x3c]	@ update count of stolen events
+	ldmia	sp!, {r4-r5,pc}	@ restore in-use registers and return event
+
+@
+@ The metered sponsor enforces event, block and time quotas at dispatch.
+@ Resources come from a root sponsor, whose handlers do the real work.
+@ When a quota is used up, dispatch sends (reason, sponsor) to the trap
+@ handler, which must grant more quota or exit. The trap event runs under
+@ the parent metered sponsor (or meter_free, at the top level), so it is
+@ not charged to the used-up quota. Events held for a used-up sponsor
+@ trap only once, until meter_grant adds quota. A sub-sponsor takes its
+@ quota out of its parent's remaining quota (see meter_grant).
+@ Metered sponsors that share a root also share its event queue, so each
+@ event is queued after a tag naming the sponsor that sent it. Dispatch
+@ switches to that sponsor, and charges the event to its quota.
+@
+	.data
+	.align 5		@ align to cache-line
+	.global sponsor_4
+sponsor_4:
+	.int	dispatch_m	@ 0x00: dispatch the next event (ip=actor, fp=event)
+	.int	complete_m	@ 0x04: complete event dispatch (fp=event)
+	.int	reserve_m	@ 0x08: reserve memory block (32 bytes)
+	.int	release_m	@ 0x0c: release memory block (r0)
+	.int	enqueue_m	@ 0x10: enqueue event (r0)
+	.int	dequeue_m	@ 0x14: dequeue next event, or 0 (r1=sponsor)
+	.int	a_quota		@ 0x18: trap handler, or 0 to exit
+	.int	0		@ 0x1c: current event (trap reason, once trapped)
+	.int	reserve_n_m	@ 0x20: reserve memory block (r0=size, up to 256 bytes)
+	.int	release_n_m	@ 0x24: release memory block (r0=block, r1=size)
+	.int	sponsor_0	@ 0x28: root sponsor
+	.int	0		@ 0x2c: events remaining
+	.int	0		@ 0x30: blocks remaining (32-byte units)
+	.int	0		@ 0x34: microseconds remaining
+	.int	0		@ 0x38: dispatch start time
+	.int	0		@ 0x3c: parent metered sponsor, or 0 for none
+
+	.align 5		@ align to cache-line
+meter_free:		@ unmetered sponsor, for top-level trap handlers
+	.int	dispatch_m	@ 0x00: dispatch the next event (ip=actor, fp=event)
+	.int	complete_m	@ 0x04: complete event dispatch (fp=event)
+	.int	reserve_m	@ 0x08: reserve memory block (32 bytes)
+	.int	release_m	@ 0x0c: release memory block (r0)
+	.int	enqueue_m	@ 0x10: enqueue event (r0)
+	.int	dequeue_m	@ 0x14: dequeue next event, or 0 (r1=sponsor)
+	.int	0		@ 0x18: trap handler (never trapped)
+	.int	0		@ 0x1c: current event
+	.int	reserve_n_m	@ 0x20: reserve memory block (r0=size, up to 256 bytes)
+	.int	release_n_m	@ 0x24: release memory block (r0=block, r1=size)
+	.int	sponsor_0	@ 0x28: root sponsor (copied from trapped sponsor)
+	.int	0		@ 0x2c: events used (never checked)
+	.int	0		@ 0x30: blocks used (never checked)
+	.int	0		@ 0x34: microseconds used (never checked)
+	.int	0		@ 0x38: dispatch start time
+	.int	0		@ 0x3c: no parent
+
+	.text
+	.align 2		@ align to machine word
+	.global meter_init
+meter_init:		@ initialize metered sponsor, with no quota
+			@ (r0=sponsor, 64 bytes, r1=parent, r2=trap handler)
+	stmdb	sp!, {r4-r9,lr}	@ preserve in-use registers
+	ldr	r3, =sponsor_4	@ metered sponsor template
+	ldmia	r3, {r4-r9}	@ read handler table
+	stmia	r0, {r4-r9}	@ write handler table
+	mov	r4, #0		@ no current event
+	ldr	r5, [r3, #0x20]	@ sized reserve handler
+	ldr	r6, [r3, #0x24]	@ sized release handler
+	add	r3, r0, #0x18	@ address of handler field
+	stmia	r3, {r2,r4-r6}	@ write 0x18..0x24
+	ldr	r3, [r1]	@ get parent dispatch handler
+	ldr	r4, =dispatch_m	@ metered dispatch handler
+	teq	r3, r4		@ if parent is metered
+	ldreq	r4, [r1, #0x28]	@	share parent's root sponsor
+	moveq	r9, r1		@	charge grants to parent
+	movne	r4, r1		@ else parent is root sponsor
+	movne	r9, #0		@	grants are free
+	mov	r5, #0		@ no events
+	mov	r6, #0		@ no blocks
+	mov	r7, #0		@ no time
+	mov	r8, #0		@ no dispatch start time
+	add	r3, r0, #0x28	@ address of root sponsor field
+	stmia	r3, {r4-r9}	@ write 0x28..0x3c
+	ldmia	sp!, {r4-r9,pc}	@ restore in-use registers and return
+
+	.text
+	.align 2		@ align to machine word
+	.global meter_grant
+meter_grant:		@ add quota to metered sponsor, taken from parent
+			@ (r0=sponsor, r1=events, r2=blocks, r3=usecs)
+			@ returns 1 on success, 0 if parent has too little
+	stmdb	sp!, {r4-r5,lr}	@ preserve in-use registers
+	ldr	r4, [r0, #0x3c]	@ get parent metered sponsor
+	teq	r4, #0		@ if parent is metered
+	beq	1f
+	ldr	r5, [r4, #0x2c]	@	get parent events remaining
+	subs	r5, r5, r1	@	take events
+	blt	2f		@	if not enough, fail
+	str	r5, [r4, #0x2c]
+	ldr	r5, [r4, #0x30]	@	get parent blocks remaining
+	subs	r5, r5, r2	@	take blocks
+	blt	3f		@	if not enough, undo and fail
+	str	r5, [r4, #0x30]
+	ldr	r5, [r4, #0x34]	@	get parent time remaining
+	subs	r5, r5, r3	@	take time
+	blt	4f		@	if not enough, undo and fail
+	str	r5, [r4, #0x34]
+1:
+	mov	r5, #0		@ re-arm trap
+	str	r5, [r0, #0x1c]	@ release held events
+	ldr	r5, [r0, #0x2c]	@ get events remaining
+	add	r5, r5, r1	@ add events
+	str	r5, [r0, #0x2c]
+	ldr	r5, [r0, #0x30]	@ get blocks remaining
+	add	r5, r5, r2	@ add blocks
+	str	r5, [r0, #0x30]
+	ldr	r5, [r0, #0x34]	@ get time remaining
+	add	r5, r5, r3	@ add time
+	str	r5, [r0, #0x34]
+	mov	r0, #1		@ success
+	ldmia	sp!, {r4-r5,pc}	@ restore in-use registers and return
+4:
+	ldr	r5, [r4, #0x30]	@ give blocks back to parent
+	add	r5, r5, r2
+	str	r5, [r4, #0x30]
+3:
+	ldr	r5, [r4, #0x2c]	@ give events back to parent
+	add	r5, r5, r1
+	str	r5, [r4, #0x2c]
+2:
+	mov	r0, #0		@ fail!
+	ldmia	sp!, {r4-r5,pc}	@ restore in-use registers and return
+
+	.text
+	.align 2		@ align to machine word
+complete_m:		@ completion of event pointed to by fp
+	bl	timer_usecs	@ get current timer value
+	ldr	r1, [sl, #0x38]	@ get dispatch start time
+	sub	r0, r0, r1	@ time used by event
+	ldr	r1, [sl, #0x34]	@ get time remaining
+	sub	r1, r1, r0	@ charge time used
+	str	r1, [sl, #0x34]	@ update time remaining
+	mov	r0, fp		@ get completed event
+	bl	release_m	@ free completed event
+	mov	fp, #0		@ clear frame pointer
+	str	fp, [sl, #0x1c]	@ clear current event
+	@ WARNING! complete falls through to dispatch...
+dispatch_m:		@ dispatch next event, within its sponsor's quota
+	bl	irq_check	@ deliver interrupt events, if any
+	bl	dequeue_m	@ try to get next event
+	teq	r0, #0		@ check for null
+	beq	dispatch_m	@ if no event, try again...
+
+	mov	fp, r0		@ initialize frame pointer
+	mov	sl, r1		@ switch to sponsor that sent the event
+	ldr	r0, =meter_free	@ unmetered sponsor
+	teq	r0, sl		@ if event is unmetered
+	beq	1f		@	skip quota checks
+	mov	r1, #1		@ reason 1: events
+	ldr	r0, [sl, #0x2c]	@ get events remaining
+	cmp	r0, #0		@ if none left
+	ble	meter_hold	@	hold event, trap to handler
+	mov	r1, #2		@ reason 2: blocks
+	ldr	r0, [sl, #0x30]	@ get blocks remaining
+	cmp	r0, #0		@ if none left
+	ble	meter_hold	@	hold event, trap to handler
+	mov	r1, #3		@ reason 3: time
+	ldr	r0, [sl, #0x34]	@ get time remaining
+	cmp	r0, #0		@ if none left
+	ble	meter_hold	@	hold event, trap to handler
+	ldr	r0, [sl, #0x2c]	@ get events remaining
+	sub	r0, r0, #1	@ charge one event
+	str	r0, [sl, #0x2c]	@ update events remaining
+1:
+	bl	timer_usecs	@ get current timer value
+	str	r0, [sl, #0x38]	@ remember dispatch start time
+	str	fp, [sl, #0x1c]	@ update current event
+	ldr	ip, [fp]	@ get target actor address
+	bx	ip		@ jump to actor behavior
+
+meter_hold:		@ quota used up, requeue event fp and trap (once)
+			@ (r1=reason)
+	mov	r4, r1		@ preserve reason
+	mov	r0, fp		@ get held event
+	bl	enqueue_m	@ requeue event, still charged to this sponsor
+	mov	fp, #0		@ clear frame pointer
+	ldr	r0, [sl, #0x1c]	@ get trap reason
+	teq	r0, #0		@ if already trapped
+	bne	dispatch_m	@	hold until meter_grant
+	mov	r1, r4		@ restore reason
+	@ WARNING! meter_hold falls through to meter_trap...
+meter_trap:		@ quota used up, dispatch (reason, sponsor) to handler
+			@ (r1=reason)
+	ldr	r4, [sl, #0x18]	@ get trap handler
+	teq	r4, #0		@ if no handler
+	beq	exit		@	kernel exit!
+	str	r1, [sl, #0x1c]	@ remember trap taken
+	mov	r5, r1		@ message[0] = reason
+	mov	r6, sl		@ message[1] = sponsor
+	ldr	r0, [sl, #0x3c]	@ get parent metered sponsor
+	teq	r0, #0		@ if none
+	ldreq	r0, =meter_free	@	run handler unmetered
+	ldreq	r1, [sl, #0x28]	@	get root sponsor
+	streq	r1, [r0, #0x28]	@	share root sponsor
+	mov	sl, r0		@ switch to parent (or unmetered) sponsor
+	ldr	r0, [sl, #0x2c]	@ get events remaining
+	sub	r0, r0, #1	@ charge one event
+	str	r0, [sl, #0x2c]	@ update events remaining
+	bl	reserve_m	@ allocate trap event
+	stmia	r0, {r4-r6}	@ write trap event
+	mov	fp, r0		@ initialize frame pointer
+	bl	timer_usecs	@ get current timer value
+	str	r0, [sl, #0x38]	@ remember dispatch start time
+	str	fp, [sl, #0x1c]	@ update current event
+	mov	ip, r4		@ get trap handler address
+	bx	ip		@ jump to handler behavior
+
+reserve_m:		@ reserve a block (32 bytes), charged to quota
+	ldr	r0, [sl, #0x30]	@ get blocks remaining
+	sub	r0, r0, #1	@ charge one block
+	str	r0, [sl, #0x30]	@ update blocks remaining
+	b	reserve_r	@ reserve from root sponsor
+
+release_m:		@ release the memory block pointed to by r0
+	ldr	r1, [sl, #0x30]	@ get blocks remaining
+	add	r1, r1, #1	@ credit one block
+	str	r1, [sl, #0x30]	@ update blocks remaining
+	b	release_r	@ release to root sponsor
+
+reserve_n_m:		@ reserve a block of r0 bytes, charged to quota
+	cmp	r0, #256	@ if size too large
+	bhi	reserve_n_r	@	don't charge (reserve fails)
+	mov	r1, #1		@ 32-byte units for size class
+	cmp	r0, #32
+	movhi	r1, #2
+	cmp	r0, #64
+	movhi	r1, #4
+	cmp	r0, #128
+	movhi	r1, #8
+	ldr	r2, [sl, #0x30]	@ get blocks remaining
+	sub	r2, r2, r1	@ charge size class
+	str	r2, [sl, #0x30]	@ update blocks remaining
+	b	reserve_n_r	@ reserve from root sponsor
+
+enqueue_m:		@ enqueue event r0, tagged with this sponsor
+	stmdb	sp!, {r0,sl,lr}	@ preserve event and sponsor
+	mov	r0, sl		@ sponsor tag
+	ldr	sl, [sl, #0x28]	@ switch to root sponsor
+	bl	enqueue		@ enqueue tag with root sponsor
+	ldr	r0, [sp]	@ recall event
+	bl	enqueue		@ enqueue event right after its tag
+	ldmia	sp!, {r0,sl,pc}	@ restore sponsor and return
+
+dequeue_m:		@ dequeue next event from root sponsor, or 0
+			@ (returns r0=event, r1=sponsor that sent it)
+	stmdb	sp!, {r4,sl,lr}	@ preserve in-use registers
+	ldr	sl, [sl, #0x28]	@ switch to root sponsor
+	bl	dequeue		@ get sponsor tag
+	movs	r4, r0		@ if queue empty
+	beq	1f		@	return null
+	bl	dequeue		@ get event that follows its tag
+1:
+	mov	r1, r4		@ sponsor that sent the event
+	ldmia	sp!, {r4,sl,pc}	@ restore sponsor and return
+
+	.global meter_enqueue
+meter_enqueue:		@ enqueue event r0, to run under metered sponsor r1
+	stmdb	sp!, {sl,lr}	@ preserve sponsor
+	mov	sl, r1		@ switch to metered sponsor
+	bl	enqueue_m	@ enqueue tagged event
+	ldmia	sp!, {sl,pc}	@ restore sponsor and return
+
+release_n_m:		@ release block r0 of r1 bytes, credited to quota
+	mov	r2, #1		@ 32-byte units for size class
+	cmp	r1, #32
+	movhi	r2, #2
+	cmp	r1, #64
+	movhi	r2, #4
+	cmp	r1, #128
+	movhi	r2, #8
+	ldr	r3, [sl, #0x30]	@ get blocks remaining
+	add	r3, r3, r2	@ credit size class
+	str	r3, [sl, #0x30]	@ update blocks remaining
+	b	release_n_r	@ release to root sponsor
+
+@
+@ Sponsors that wrap a root sponsor (at 0x28) delegate resource handling
+@
+	.text
+	.align 2		@ align to machine word
+reserve_r:		@ reserve a block (32 bytes) from root sponsor
+	stmdb	sp!, {sl,lr}	@ preserve sponsor
+	ldr	sl, [sl, #0x28]	@ switch to root sponsor
+	bl	reserve		@ reserve from root sponsor
+	ldmia	sp!, {sl,pc}	@ restore sponsor and return
+
+release_r:		@ release the memory block r0 to root sponsor
+	stmdb	sp!, {sl,lr}	@ preserve sponsor
+	ldr	sl, [sl, #0x28]	@ switch to root sponsor
+	bl	release		@ release to root sponsor
+	ldmia	sp!, {sl,pc}	@ restore sponsor and return
+
+enqueue_r:		@ enqueue event r0 with root sponsor
+	stmdb	sp!, {sl,lr}	@ preserve sponsor
+	ldr	sl, [sl, #0x28]	@ switch to root sponsor
+	bl	enqueue		@ enqueue with root sponsor
+	ldmia	sp!, {sl,pc}	@ restore sponsor and return
+
+dequeue_r:		@ dequeue next event from root sponsor, or 0
+	stmdb	sp!, {sl,lr}	@ preserve sponsor
+	ldr	sl, [sl, #0x28]	@ switch to root sponsor
+	bl	dequeue		@ dequeue with root sponsor
+	ldmia	sp!, {sl,pc}	@ restore sponsor and return
+
+reserve_n_r:		@ reserve a block of r0 bytes from root sponsor
+	stmdb	sp!, {sl,lr}	@ preserve sponsor
+	ldr	sl, [sl, #0x28]	@ switch to root sponsor
+	bl	reserve_n	@ reserve from root sponsor
+	ldmia	sp!, {sl,pc}	@ restore sponsor and return
+
+release_n_r:		@ release block r0 of r1 bytes to root sponsor
+	stmdb	sp!, {sl,lr}	@ preserve sponsor
+	ldr	sl, [sl, #0x28]	@ switch to root sponsor
+	bl	release_n	@ release to root sponsor
+	ldmia	sp!, {sl,pc}	@ restore sponsor and return
+
+@
+@ The profiling sponsor samples the ARM11 performance monitor around
+@ each event, and passes the counts for the target actor to profile_record
+@
+	.data
+	.align 5		@ align to cache-line
+	.global sponsor_5
+sponsor_5:
+	.int	dispatch_p	@ 0x00: dispatch the next event (ip=actor, fp=event)
+	.int	complete_p	@ 0x04: complete event dispatch (fp=event)
+	.int	reserve_r	@ 0x08: reserve memory block (32 bytes)
+	.int	release_r	@ 0x0c: release memory block (r0)
+	.int	enqueue_r	@ 0x10: enqueue event (r0)
+	.int	dequeue_r	@ 0x14: dequeue next event, or 0
+	.int	0		@ 0x18: --
+	.int	0		@ 0x1c: current event
+	.int	reserve_n_r	@ 0x20: reserve memory block (r0=size, up to 256 bytes)
+	.int	release_n_r	@ 0x24: release memory block (r0=block, r1=size)
+	.int	sponsor_0	@ 0x28: root sponsor
+	.int	0		@ 0x2c: cycle count at dispatch
+	.int	0		@ 0x30: data cache miss count at dispatch
+	.int	0		@ 0x34: instruction cache miss count at dispatch
+
+	.text
+	.align 2		@ align to machine word
+	.global pmu_start
+pmu_start:		@ reset and enable ARM11 performance counters
+	ldr	r0, =0x00B00007	@ PMN0=D-cache miss, PMN1=I-cache miss, reset, enable
+	mcr	p15, 0, r0, c15, c12, 0 @ write performance monitor control
+	bx	lr		@ return
+
+	.text
+	.align 2		@ align to machine word
+complete_p:		@ completion of event pointed to by fp
+	mrc	p15, 0, r4, c15, c12, 1 @ read cycle count
+	mrc	p15, 0, r5, c15, c12, 2 @ read data cache miss count
+	mrc	p15, 0, r6, c15, c12, 3 @ read instruction cache miss count
+	add	r0, sl, #0x2c	@ address of counts at dispatch
+	ldmia	r0, {r1-r3}	@ get counts at dispatch
+	sub	r1, r4, r1	@ cycles used by event
+	sub	r2, r5, r2	@ data cache misses by event
+	sub	r3, r6, r3	@ instruction cache misses by event
+	ldr	r0, [fp]	@ get target actor address
+	bl	profile_record	@ accumulate counts for behavior
+	mov	r0, fp		@ get completed event
+	bl	release_r	@ free completed event
+	mov	fp, #0		@ clear frame pointer
+	str	fp, [sl, #0x1c]	@ clear current event
+	@ WARNING! complete falls through to dispatch...
+dispatch_p:		@ dispatch next event
+	bl	irq_check	@ deliver interrupt events, if any
+	bl	dequeue_r	@ try to get next event
+	teq	r0, #0		@ check for null
+	beq	dispatch_p	@ if no event, try again...
+
+	mov	fp, r0		@ initialize frame pointer
+	str	fp, [sl, #0x1c]	@ update current event
+	mrc	p15, 0, r1, c15, c12, 1 @ read cycle count
+	mrc	p15, 0, r2, c15, c12, 2 @ read data cache miss count
+	mrc	p15, 0, r3, c15, c12, 3 @ read instruction cache miss count
+	add	r0, sl, #0x2c	@ address of counts at dispatch
+	stmia	r0, {r1-r3}	@ remember counts at dispatch
+	ldr	ip, [fp]	@ get target actor address
+	bx	ip		@ jump to actor behavior
+
 @
 @ Common actor examples and templates
 @
@@ -800,6 +1733,18 @@ a_failed:		@ report tests failed, and exit
 	.int	0		@ 0x14: --
 	.ascii	"FAILED!\0"	@ 0x18..0x1f: output text
 
+	.text
+	.align 5		@ align to cache-line
+	.global a_quota
+a_quota:		@ report quota used up, and exit
+	add	r0, ip, #0x18	@ address of output text
+	bl	serial_puts	@ write output text
+	bl	serial_eol	@ write end-of-line
+	b	exit		@ kernel exit!
+	.int	0		@ 0x10: --
+	.int	0		@ 0x14: --
+	.ascii	"QUOTA!!\0"	@ 0x18..0x1f: output text
+
 	.text
 	.align 5		@ align to cache-line
 	.global a_exitq
@@ -821,7 +1766,7 @@ a_bench:		@ benchmark bootstrap actor
 
 	.text
 	.align 5		@ align to cache-line
-	.global a_bench
+	.global a_bench2
 a_bench2:		@ benchmark bootstrap actor
 	mov	ip, pc		@ point ip to data fields (state)
 	ldmia	ip,{r4-r8,pc}	@ copy state and jump to behavior
@@ -832,6 +1777,32 @@ a_bench2:		@ benchmark bootstrap actor
 	.int	0		@ 0x10: r8 = --
 	.int	b_bench		@ 0x14: behavior
 
+	.text
+	.align 5		@ align to cache-line
+	.global a_bench_tree
+a_bench_tree:		@ fork/join benchmark bootstrap actor
+	mov	ip, pc		@ point ip to data fields (state)
+	ldmia	ip,{r4-r8,pc}	@ copy state and jump to behavior
+	.int	b_fbomb		@ 0x00: r4 = child behavior
+	.int	0		@ 0x04: r5 = child state
+	.int	a_exitq		@ 0x08: r6 = child message[0] (cust)
+	.int	14		@ 0x0c: r7 = child message[1] (depth)
+	.int	0		@ 0x10: r8 = --
+	.int	b_bench		@ 0x14: behavior
+
+	.text
+	.align 5		@ align to cache-line
+	.global a_bench_ring
+a_bench_ring:		@ N-actor ring benchmark bootstrap actor
+	mov	ip, pc		@ point ip to data fields (state)
+	ldmia	ip,{r4-r8,pc}	@ copy state and jump to behavior
+	.int	100		@ 0x00: r4 = ring size
+	.int	1000000		@ 0x04: r5 = message hops
+	.int	0		@ 0x08: r6 = --
+	.int	0		@ 0x0c: r7 = --
+	.int	0		@ 0x10: r8 = --
+	.int	b_ring		@ 0x14: behavior
+
 	.text
 	.align 5		@ align to cache-line
 b_bench:		@ benchmark bootstrap behavior
@@ -899,6 +1870,45 @@ b_fbomb:		@ fork-bomb behavior
 	bl	enqueue		@ add event to queue
 	b	complete	@ return to dispatch loop
 
+	.text
+	.align 5		@ align to cache-line
+b_ring:			@ ring benchmark bootstrap behavior
+			@ (r4=ring size, r5=message hops)
+	ldr	r0, =b_ring_link @ get b_ring_link address
+	mov	r1, #0		@ next member (patched below)
+	bl	create_1	@ create first ring member
+	mov	r6, r0		@ remember first member
+	mov	r7, r0		@ member created last
+1:
+	subs	r4, r4, #1	@ decrement ring size
+	ble	2f		@ while more members needed
+	ldr	r0, =b_ring_link @	get b_ring_link address
+	mov	r1, r7		@	next is member created last
+	bl	create_1	@	create ring member
+	mov	r7, r0		@	remember member created last
+	b	1b
+2:
+	str	r7, [r6, #0x08]	@ close the ring (first member r4 = last member)
+	mov	r0, r6		@ get first member
+	mov	r1, r5		@ get message hops
+	bl	send_1		@ send (hops) around the ring
+	b	complete	@ return to dispatch loop
+
+	.text
+	.align 5		@ align to cache-line
+b_ring_link:		@ ring member behavior (r4=next member)
+			@ message = (count)
+	ldr	r1, [fp, #0x04]	@ get count
+	subs	r1, r1, #1	@ decrement count
+	bmi	1f		@ if count >= 0
+	mov	r0, r4		@	get next member
+	bl	send_1		@	send (count') to next member
+	b	complete	@	return to dispatch loop
+1:				@ else
+	ldr	r0, =a_exitq	@	get a_exitq address
+	bl	send_0		@	send empty message to exit
+	b	complete	@	return to dispatch loop
+
 	.text
 	.align 5		@ align to cache-line
 	.global dump_regs
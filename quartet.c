@@ -33,6 +33,7 @@ See further [https://github.com/organix/mycelia/blob/master/quartet.md]
 #include <stdint.h>  // for intptr_t, uintptr_t, uint8_t, uint16_t, etc.
 #include <inttypes.h>  // for PRIiPTR, PRIuPTR, PRIXPTR, etc.
 #include <ctype.h>
+#include <time.h>  // for clock_t, clock(), etc.
 
 #define DEBUG(x)   // include/exclude debug instrumentation
 #define XDEBUG(x) x // include/exclude extra debugging
@@ -518,6 +519,7 @@ PROC_DECL(prim_DUMP);
 #endif
 PROC_DECL(prim_WORDS);
 PROC_DECL(prim_USAGE);
+PROC_DECL(prim_BENCH);
 PROC_DECL(prim_EMIT);
 PROC_DECL(prim_PrintStack);
 PROC_DECL(prim_PrintDebug);
@@ -578,18 +580,20 @@ word_t word_list[MAX_WORDS] = {
 #endif
     { .value = MK_PROC(prim_WORDS), .name = "WORDS" },
     { .value = MK_PROC(prim_USAGE), .name = "USAGE" },
+    { .value = MK_PROC(prim_BENCH), .name = "BENCH" },
     { .value = MK_PROC(prim_EMIT), .name = "EMIT" },
     { .value = MK_PROC(prim_PrintStack), .name = "..." },
     { .value = MK_PROC(prim_PrintDebug), .name = ".?" },
     { .value = MK_PROC(prim_Print), .name = "." },
 };
 #if ALLOW_DMA
-size_t ro_words = 55;  // limit of read-only words
-size_t rw_words = 55;  // limit of read/write words
+size_t ro_words = 56;  // limit of read-only words
+size_t rw_words = 56;  // limit of read/write words
 #else
-size_t ro_words = 50;  // limit of read-only words
-size_t rw_words = 50;  // limit of read/write words
+size_t ro_words = 51;  // limit of read-only words
+size_t rw_words = 51;  // limit of read/write words
 #endif
+size_t ro_shadows = 0;  // number of r/w words that shadow read-only words
 
 static void debug_word(char *label, int_t word) {
     word_t *w = TO_PTR(word);
@@ -649,12 +653,47 @@ int_t next_value(int_t *value_out) {
     return parse_value(value_out);
 }
 
+/*
+ * hash index over word names, mapping each name to its latest definition
+ */
+
+#define WORD_HASH_SZ (2 * MAX_WORDS)  // must be a power of 2
+uint16_t word_hash[WORD_HASH_SZ];  // 1 + index into word_list[], or 0 if empty
+
+static nat_t hash_name(char *name) {  // FNV-1a string hash
+    nat_t h = 2166136261u;
+    while (*name) {
+        h = (h ^ (uint8_t)*name++) * 16777619u;
+    }
+    return h & (WORD_HASH_SZ - 1);
+}
+
+// find hash slot for _name_, either matching or empty
+static uint16_t *word_hash_slot(char *name) {
+    nat_t h = hash_name(name);
+    for (;;) {  // open addressing, linear probe
+        uint16_t *slot = &word_hash[h];
+        if ((*slot == 0) || (strcmp(name, word_list[*slot - 1].name) == 0)) {
+            return slot;
+        }
+        h = (h + 1) & (WORD_HASH_SZ - 1);
+    }
+}
+
+// index all words in the dictionary, later words shadow earlier ones
+void word_hash_init() {
+    memset(word_hash, 0, sizeof(word_hash));
+    for (size_t n = 0; n < rw_words; ++n) {
+        *word_hash_slot(word_list[n].name) = n + 1;
+    }
+}
+
 // convert latest token into new word
 int_t create_word(int_t *word_out, int_t word) {
     word_t *w = TO_PTR(word);
     if (rw_words >= MAX_WORDS) return panic("too many words");
     if (w != &word_list[rw_words]) return panic("must create from latest token");
-    ++rw_words;  // extend r/w dictionary
+    *word_hash_slot(w->name) = ++rw_words;  // extend r/w dictionary
     word = MK_WORD(w);
     DEBUG(debug_word("  create_word", word));
     *word_out = word;
@@ -664,14 +703,13 @@ int_t create_word(int_t *word_out, int_t word) {
 // lookup word in entire dictionary, fail if not found.
 int_t find_ro_word(int_t *word_out, int_t word) {
     word_t *w = TO_PTR(word);
-    for (size_t n = rw_words; (n-- > 0); ) {  // search from _end_ of dictionary
+    size_t n = *word_hash_slot(w->name);  // latest definition
+    if (n-- > 0) {
         word_t *m = &word_list[n];
-        if (strcmp(w->name, m->name) == 0) {
-            word = MK_WORD(m);
-            DEBUG(debug_word("  ro_word", word));
-            *word_out = word;
-            return TRUE;
-        }
+        word = MK_WORD(m);
+        DEBUG(debug_word("  ro_word", word));
+        *word_out = word;
+        return TRUE;
     }
     return FALSE;
 }
@@ -685,14 +723,13 @@ int_t get_ro_word(int_t *word_out, int_t word) {
 // lookup word in writable dictionary, fail if not found.
 int_t find_rw_word(int_t *word_out, int_t word) {
     word_t *w = TO_PTR(word);
-    for (size_t n = rw_words; (n-- > ro_words); ) {  // search from _end_ of dictionary
+    size_t n = *word_hash_slot(w->name);  // latest definition
+    if (n-- > ro_words) {  // a r/w word always shadows a read-only word
         word_t *m = &word_list[n];
-        if (strcmp(w->name, m->name) == 0) {
-            word = MK_WORD(m);
-            DEBUG(debug_word("  rw_word", word));
-            *word_out = word;
-            return TRUE;
-        }
+        word = MK_WORD(m);
+        DEBUG(debug_word("  rw_word", word));
+        *word_out = word;
+        return TRUE;
     }
     return FALSE;
 }
@@ -700,15 +737,28 @@ int_t find_rw_word(int_t *word_out, int_t word) {
 // lookup word in writable dictionary, create if not found.
 int_t get_rw_word(int_t *word_out, int_t word) {
     if (find_rw_word(word_out, word)) return TRUE;  // word already exists
+    int_t ro_word;
+    if (find_ro_word(&ro_word, word)) {
+        ++ro_shadows;  // new r/w word hides a read-only word
+    }
     return create_word(word_out, word);
 }
 
+// word is already the latest dictionary entry for its name
+static int_t is_norm_word(int_t word) {
+    word_t *w = TO_PTR(word);
+    nat_t n = NAT(w - word_list);
+    if (n >= rw_words) return FALSE;  // latest token, or not in dictionary
+    return ((n >= ro_words) || (ro_shadows == 0));
+}
+
 // get currently-bound value for word
 int_t get_word_value(int_t *value_out, int_t word) {
     // find word in current dictionary
     DEBUG(debug_word("  get_word_value (word)", word));
-    int_t norm;
-    if (!find_ro_word(&norm, word)) return undefined_word(word);
+    int_t norm = word;
+    if (!is_norm_word(word)
+    &&  !find_ro_word(&norm, word)) return undefined_word(word);
     if (norm != word) {
         if (next_context) {
             XDEBUG(debug_word("  get_word_value (NORM)", norm));  // FIXME: should not happen!
@@ -800,6 +850,7 @@ int_t set_word_value(int_t word, int_t value) {
     block = data_stack[--data_top];
 
 int_t interpret();  // FORWARD DECLARATION
+int_t exec_code();  // FORWARD DECLARATION
 int_t compile();  // FORWARD DECLARATION
 int_t get_block(int_t value);  // FORWARD DECLARATION
 int_t exec_value(int_t value);  // FORWARD DECLARATION
@@ -1017,8 +1068,15 @@ PROC_DECL(prim_Print) {
  */
 
 #define MAX_BLOCK_MEM (2 * VMEM_PAGE_SZ / sizeof(int_t))
-int_t block_mem[MAX_BLOCK_MEM];
+int_t block_space[2][MAX_BLOCK_MEM];  // semi-spaces for the old generation
+int_t *block_mem = block_space[0];
 size_t block_next = 0;
+size_t block_peak = 0;  // most block memory in use at once
+
+#define MAX_NURSERY (VMEM_PAGE_SZ / sizeof(int_t) / 4)
+int_t nursery_mem[MAX_NURSERY];  // young generation, one message at a time
+size_t nursery_next = 0;
+int_t nursery_on = FALSE;  // allocate from nursery (while dispatching)
 
 void print_block(nat_t len, int_t *data) {
     print_ascii('[');
@@ -1089,9 +1147,9 @@ int_t exec_block(nat_t cnt, int_t *ptr, env_t *env) {
     };
     next_context = &scope_context;
 
-    // run nested interpreter, reading from block
+    // run threaded dispatch, reading from block
     ++quote_depth;
-    int_t ok = interpret();  // FIXME: consider an exit_on_fail parameter?
+    int_t ok = exec_code();  // FIXME: consider an exit_on_fail parameter?
     --quote_depth;
 
     // restore previous value source
@@ -1109,14 +1167,20 @@ PROC_DECL(prim_Block) {
 
 // allocate _cnt_ consecutive `int_t` slots
 int_t new_block(int_t *block_out, nat_t cnt) {
-    size_t next = block_next + cnt;
-    if (next > MAX_BLOCK_MEM) {
-        return panic("out of heap memory");
+    block_t *blk;
+    if (nursery_on && ((nursery_next + cnt) <= MAX_NURSERY)) {
+        blk = PTR(&nursery_mem[nursery_next]);
+        nursery_next += cnt;
+    } else {  // on overflow, allocate directly in the old generation
+        size_t next = block_next + cnt;
+        if (next > MAX_BLOCK_MEM) {
+            return panic("out of heap memory");
+        }
+        blk = PTR(&block_mem[block_next]);
+        block_next = next;
     }
-    block_t *blk = PTR(&block_mem[block_next]);
     blk->proc = MK_PROC(prim_Block);
     blk->len = cnt - 2;
-    block_next = next;
     *block_out = MK_BLOCK(blk);
     DEBUG(debug_value("  new_block", *block_out));
     return TRUE;
@@ -1169,6 +1233,81 @@ int_t make_closure(int_t *block_out, int_t block) {
     return TRUE;
 }
 
+/*
+ * block garbage collection
+ */
+
+PROC_DECL(prim_Forward) { return panic("Forward can not be executed"); }
+
+int_t *gc_from_base = PTR(0);  // space being evacuated
+size_t gc_from_size = 0;
+size_t gc_limit = MAX_BLOCK_MEM / 2;  // old generation collection threshold
+size_t gc_major_cnt = 0;  // number of old generation collections
+size_t gc_promoted = 0;  // number of `int_t` promoted from the nursery
+
+// number of `int_t` slots occupied by _blk_
+static nat_t block_size(block_t *blk) {
+    if (blk->proc == MK_PROC(prim_Block)) return blk->len + 2;
+    if (blk->proc == MK_PROC(prim_Actor)) return 2;
+    return 4;  // Environment or Closure
+}
+
+// copy block at _ptr_ to `block_mem`, unless already moved
+static ptr_t gc_copy(ptr_t ptr) {
+    block_t *blk = ptr;
+    if (NAT(PTR(blk) - PTR(gc_from_base)) >= (gc_from_size * sizeof(int_t))) {
+        return ptr;  // not in from-space
+    }
+    if (blk->proc == MK_PROC(prim_Forward)) {
+        return PTR(blk->len);  // already moved
+    }
+    nat_t cnt = block_size(blk);
+    if ((block_next + cnt) > MAX_BLOCK_MEM) {
+        return PTR(panic("out of heap memory"));
+    }
+    block_t *dst = PTR(&block_mem[block_next]);
+    memcpy(dst, blk, cnt * sizeof(int_t));
+    block_next += cnt;
+    blk->proc = MK_PROC(prim_Forward);  // leave forwarding address
+    blk->len = NAT(dst);
+    return dst;
+}
+
+int_t gc_value(int_t value) {
+    if (IS_BLOCK(value)) {
+        return MK_BLOCK(gc_copy(TO_PTR(value)));
+    }
+    return value;
+}
+
+// update references held by blocks in `block_mem` from _scan_ onward
+static void gc_scan(size_t scan) {
+    while (scan < block_next) {
+        block_t *blk = PTR(&block_mem[scan]);
+        if (blk->proc == MK_PROC(prim_Block)) {
+            for (nat_t n = 0; n < blk->len; ++n) {
+                blk->data[n] = gc_value(blk->data[n]);
+            }
+        } else if (blk->proc == MK_PROC(prim_Closure)) {
+            closure_t *scope = PTR(blk);
+            if (scope->ptr) {  // closures always refer to the start of block data
+                block_t *code = PTR(PTR(scope->ptr) - offsetof(block_t, data));
+                code = gc_copy(code);
+                scope->ptr = code->data;
+            }
+            scope->env = gc_copy(scope->env);
+        } else if (blk->proc == MK_PROC(prim_Environment)) {
+            env_t *env = PTR(blk);
+            env->value = gc_value(env->value);
+            env->env = gc_copy(env->env);
+        } else if (blk->proc == MK_PROC(prim_Actor)) {
+            actor_t *act = PTR(blk);
+            act->beh = gc_value(act->beh);
+        }
+        scan += block_size(blk);
+    }
+}
+
 /*
  * word interpreter/compiler
  */
@@ -1245,6 +1384,56 @@ int_t interpret() {
     return TRUE;
 }
 
+// execute pre-resolved values from the current block
+int_t exec_code() {
+    context_t *ctx = next_context;
+    DEBUG(fprintf(stderr, "> exec_code cnt=%"PRIuPTR" ptr=%p env=%p\n",
+        ctx->cnt, ctx->ptr, ctx->env));
+    size_t exec_top = data_top;  // save stack pointer for error recovery
+    while (ctx->cnt) {
+        --ctx->cnt;
+        int_t value = *ctx->ptr++;
+        DEBUG(debug_value("  exec_code (value)", value));
+        if (IS_WORD(value)) {
+            word_t *w = TO_PTR(value);
+            if ((w->name[0] == ')') && (w->name[1] == '\0')) {
+                DEBUG(fprintf(stderr, "< exec_code unquote data_top=%zu\n", data_top));
+                return TRUE;  // end of unquote...
+            }
+            if ((w->name[0] == '[') && (w->name[1] == '\0')) {
+                if (!get_block(value)) goto fail;  // compile quoted block
+                value = data_stack[--data_top];  // pop block from stack
+                goto quoted;
+            }
+            // words in a block are normalized by compile()
+            if (!get_word_value(&value, value)) goto fail;
+        } else if (IS_BLOCK(value)) {
+quoted:
+            if (!make_closure(&value, value)) goto fail;
+            if (!data_push(value)) goto fail;  // push block on stack
+            continue;
+        }
+        // dispatch directly to procedure
+        if (IS_BLOCK(value)) {
+            block_t *blk = TO_PTR(value);
+            PROC_DECL((*proc)) = TO_PTR(blk->proc);
+            if ((*proc)(value)) continue;
+        } else if (IS_PROC(value)) {
+            PROC_DECL((*proc)) = TO_PTR(value);
+            if ((*proc)(value)) continue;
+        } else if (data_push(value)) {
+            continue;
+        }
+fail:
+        data_top = exec_top;  // restore stack on failure
+        DEBUG(fprintf(stderr, "< exec_code FAIL! data_top=%zu\n", data_top));
+        return FALSE;
+    }
+    ctx->ptr = PTR(0);  // no more words (in block)
+    DEBUG(fprintf(stderr, "< exec_code ok data_top=%zu\n", data_top));
+    return TRUE;
+}
+
 int_t quote_value(int_t value) {
     DEBUG(debug_value("  quote_value (value)", value));
     if (IS_WORD(value)) {
@@ -1306,34 +1495,76 @@ int_t compile() {
  * actor runtime
  */
 
-#define MAX_MSG_RING (VMEM_PAGE_SZ / sizeof(int_t))
-#define MASK_MSG_RING (MAX_MSG_RING - 1)
-int_t msg_ring[MAX_MSG_RING];  // ring buffer for messages in transit
-int_t msg_head = 0;
+#define MAX_MSG_RING (VMEM_PAGE_SZ / sizeof(int_t))  // initial ring size
+#define LIMIT_MSG_RING (MAX_MSG_RING << 8)  // largest ring size
+int_t msg_ring_mem[MAX_MSG_RING] __attribute__((aligned(CACHE_LINE_SZ)));
+int_t *msg_ring = msg_ring_mem;  // ring buffer for messages in transit
+nat_t msg_ring_sz = MAX_MSG_RING;  // power of 2
+int_t msg_head = 0;  // (note: positions only increase, see MSG_IDX)
 int_t msg_tail = 0;
+#define MSG_IDX(pos) (NAT(pos) & (msg_ring_sz - 1))
+
+// ensure room for _cnt_ more values, growing the ring if needed
+int_t msg_reserve(nat_t cnt) {
+    nat_t used = NAT(msg_tail - msg_head);
+    if ((used + cnt) <= msg_ring_sz) return TRUE;
+    nat_t size = msg_ring_sz;
+    while ((used + cnt) > size) {
+        size <<= 1;
+    }
+    if (size > LIMIT_MSG_RING) return error("message queue overflow");
+    int_t *ring = aligned_alloc(CACHE_LINE_SZ, size * sizeof(int_t));
+    if (!ring) return error("message queue overflow");
+    for (int_t pos = msg_head; pos != msg_tail; ++pos) {  // keep positions
+        ring[NAT(pos) & (size - 1)] = msg_ring[MSG_IDX(pos)];
+    }
+    if (msg_ring != msg_ring_mem) {
+        free(msg_ring);
+    }
+    msg_ring = ring;
+    msg_ring_sz = size;
+    DEBUG(fprintf(stderr, "  msg_reserve: grow to %"PRIuPTR"\n", msg_ring_sz));
+    return TRUE;
+}
+
+// copy _cnt_ values from _src_ to the ring, starting at _pos_
+static void msg_write(int_t pos, int_t *src, nat_t cnt) {
+    nat_t ofs = MSG_IDX(pos);
+    nat_t span = msg_ring_sz - ofs;  // contiguous values before wrap-around
+    if (span > cnt) span = cnt;
+    memcpy(&msg_ring[ofs], src, span * sizeof(int_t));
+    memcpy(msg_ring, src + span, (cnt - span) * sizeof(int_t));
+}
+
+// copy _cnt_ values from the ring, starting at _pos_, to _dst_
+static void msg_read(int_t *dst, int_t pos, nat_t cnt) {
+    nat_t ofs = MSG_IDX(pos);
+    nat_t span = msg_ring_sz - ofs;  // contiguous values before wrap-around
+    if (span > cnt) span = cnt;
+    memcpy(dst, &msg_ring[ofs], span * sizeof(int_t));
+    memcpy(dst + span, msg_ring, (cnt - span) * sizeof(int_t));
+}
 
 int_t msg_put(int_t value) {
-    msg_ring[msg_tail++] = value;
-    msg_tail &= MASK_MSG_RING;  // wrap-around
-    if (msg_head == msg_tail) return error("message queue overflow");
+    if (!msg_reserve(1)) return FALSE;
+    msg_ring[MSG_IDX(msg_tail++)] = value;
     return TRUE;
 }
 
 int_t msg_take(int_t *value_out) {
     if (msg_head == msg_tail) return error("message queue underflow");
-    *value_out = msg_ring[msg_head++];
-    msg_head &= MASK_MSG_RING;  // wrap-around
+    *value_out = msg_ring[MSG_IDX(msg_head++)];
     return TRUE;
 }
 
 // move stack contents to message queue
 int_t msg_enqueue() {
+    if (!msg_reserve(data_top + 1)) return FALSE;
     // store message length (note: natural, not tagged)
-    if (!msg_put(INT(data_top))) return FALSE;
+    msg_ring[MSG_IDX(msg_tail++)] = INT(data_top);
     // copy from stack to message
-    for (nat_t n = 0; n < data_top; ++n) {
-        if (!msg_put(data_stack[n])) return FALSE;
-    }
+    msg_write(msg_tail, data_stack, data_top);
+    msg_tail += data_top;
     // clear stack
     data_top = 0;
     // return success
@@ -1346,15 +1577,83 @@ int_t msg_dequeue() {
     // load message length (note: natural, not tagged)
     if (!msg_take(&value)) return FALSE;
     nat_t len = NAT(value);
+    if (NAT(msg_tail - msg_head) < len) return error("message queue underflow");
+    if ((data_top + len) > MAX_STACK) return stack_overflow();
     // transfer message to stack
-    while (len--) {
-        if (!msg_take(&value)) return FALSE;
-        if (!data_push(value)) return FALSE;
-    }
+    msg_read(&data_stack[data_top], msg_head, len);
+    msg_head += len;
+    data_top += len;
     // return success
     return TRUE;
 }
 
+// update references held by messages between _head_ and _tail_
+static void gc_msgs(int_t head, int_t tail) {
+    while (head != tail) {
+        int_t *target = &msg_ring[MSG_IDX(head++)];
+        *target = gc_value(*target);
+        nat_t len = NAT(msg_ring[MSG_IDX(head++)]);  // (note: natural, not tagged)
+        while (len--) {
+            int_t *value = &msg_ring[MSG_IDX(head++)];
+            *value = gc_value(*value);
+        }
+    }
+}
+
+// update references held by the r/w dictionary
+static void gc_words(size_t from) {
+    for (size_t n = from; n < rw_words; ++n) {
+        word_list[n].value = gc_value(word_list[n].value);
+    }
+}
+
+// promote nursery blocks that escaped from the current message
+void gc_minor(int_t self, size_t scan, int_t org_tail) {
+    DEBUG(fprintf(stderr, "> gc_minor nursery_next=%zu\n", nursery_next));
+    size_t org_next = block_next;
+    gc_from_base = nursery_mem;
+    gc_from_size = nursery_next;
+    actor_t *act = TO_PTR(self);
+    act->beh = gc_value(act->beh);  // BECOME
+    gc_msgs(org_tail, msg_tail);  // SEND
+    gc_words(ro_words);
+    gc_scan(scan);  // includes anything allocated past the nursery
+    gc_from_size = 0;
+    nursery_next = 0;
+    gc_promoted += block_next - org_next;
+    DEBUG(fprintf(stderr, "< gc_minor promoted=%zu\n", block_next - org_next));
+}
+
+// compact the old generation, copying live blocks to the other semi-space
+void gc_major() {
+    DEBUG(fprintf(stderr, "> gc_major block_next=%zu\n", block_next));
+    gc_from_base = block_mem;
+    gc_from_size = block_next;
+    block_mem = (block_mem == block_space[0]) ? block_space[1] : block_space[0];
+    block_next = 0;
+    gc_words(0);
+    gc_msgs(msg_head, msg_tail);
+    for (size_t n = 0; n < data_top; ++n) {
+        data_stack[n] = gc_value(data_stack[n]);
+    }
+    gc_scan(0);
+    gc_from_size = 0;
+    gc_limit = block_next + (MAX_BLOCK_MEM - block_next) / 2;
+    if (gc_limit > (MAX_BLOCK_MEM - MAX_NURSERY)) {
+        gc_limit = MAX_BLOCK_MEM - MAX_NURSERY;  // room to promote a full nursery
+    }
+    ++gc_major_cnt;
+    DEBUG(fprintf(stderr, "< gc_major block_next=%zu\n", block_next));
+}
+
+// collect the old generation if it has grown past `gc_limit`
+static void gc_safepoint() {
+    if ((block_next > gc_limit)
+    &&  (next_context == PTR(0))) {  // no block references held by callers
+        gc_major();
+    }
+}
+
 void print_actor(actor_t *act) {
     printf("^%p", act);
 }
@@ -1391,14 +1690,22 @@ int_t exec_actor(actor_t *act) {
     size_t org_next = block_next;  // save block allocation offset
 
     // execute actor behavior
+    nursery_on = TRUE;
     int_t ok = exec_value(org_beh);
+    nursery_on = FALSE;
+    if (block_next + nursery_next > block_peak) {
+        block_peak = block_next + nursery_next;  // high-water mark, see BENCH
+    }
 
-    if (!ok) {
+    if (ok) {
+        gc_minor(actor_self, org_next, org_tail);  // keep what escaped
+    } else {
         // restore recovery snapshot
         XDEBUG(fprintf(stderr, "  exec_actor restore recovery snapshot...\n"));
         act->beh = org_beh;  // restore actor behavior
         msg_tail = org_tail;  // restore message queue tail position
         block_next = org_next;  // restore block allocation offset
+        nursery_next = 0;  // discard nursery
     }
     DEBUG(fprintf(stderr, "  exec_actor (msg_head'): %"PRIdPTR"\n", msg_head));
     DEBUG(fprintf(stderr, "  exec_actor (msg_tail'): %"PRIdPTR"\n", msg_tail));
@@ -1442,6 +1749,7 @@ PROC_DECL(prim_BECOME) {
 
 int_t msg_send(int_t target) {
     if (!IS_ACTOR(target)) return error("SEND to non-Actor");
+    if (!msg_reserve(data_top + 2)) return FALSE;
     int_t org_tail = msg_tail;  // recovery snapshot
     if (msg_put(target)
     &&  msg_enqueue()) {
@@ -1456,6 +1764,7 @@ PROC_DECL(prim_SEND) {
     return msg_send(target);
 }
 
+nat_t msg_dispatch_cnt = 0;  // messages dispatched, see BENCH
 int_t msg_dispatch() {
     data_top = 0;  // clear the stack
     if (msg_head == msg_tail) return error("empty message queue");
@@ -1463,19 +1772,27 @@ int_t msg_dispatch() {
     int_t target;
     if (msg_take(&target)
     &&  msg_dequeue()) {
+        ++msg_dispatch_cnt;
         return exec_actor(TO_PTR(target));
     }
     msg_head = org_head;  // restore snapshot on failure
     return FALSE;
 }
 
+#define MSG_BATCH (64)  // messages dispatched between housekeeping checks
 PROC_DECL(prim_STEP) {
+    gc_safepoint();
     int_t ok = msg_dispatch();
     return data_push(ok);
 }
 PROC_DECL(prim_RUN) {
     while (msg_head != msg_tail) {
-        int_t ok = msg_dispatch();  // ignore failures...
+        gc_safepoint();
+        // drain a batch, stopping early if the old generation needs collection
+        nat_t n = MSG_BATCH;
+        do {
+            int_t ok = msg_dispatch();  // ignore failures...
+        } while (--n && (msg_head != msg_tail) && (block_next <= gc_limit));
     }
     return TRUE;
 }
@@ -1486,9 +1803,33 @@ PROC_DECL(prim_USAGE) {
         INT(rw_words), INT(MAX_WORDS-1), INT(percent(rw_words, MAX_WORDS-1)));
     printf("HEAP:  %4"PRIdPTR" of %4"PRIdPTR"  (%"PRIdPTR"%%)\n",
         INT(block_next), INT(MAX_BLOCK_MEM), INT(percent(block_next, MAX_BLOCK_MEM)));
+    printf("GC:    %4"PRIdPTR" major, %"PRIdPTR" promoted\n",
+        INT(gc_major_cnt), INT(gc_promoted));
     int_t msg_count = msg_tail - msg_head;
     printf("MSG_Q: %4"PRIdPTR" of %4"PRIdPTR"  (%"PRIdPTR"%%)\n",
-        INT(msg_count), INT(MAX_MSG_RING-1), INT(percent(msg_count, MAX_MSG_RING-1)));
+        INT(msg_count), INT(msg_ring_sz), INT(percent(msg_count, msg_ring_sz)));
+    return TRUE;
+}
+
+PROC_DECL(prim_BENCH) {  // ( label -- )
+    static nat_t prev_cnt = 0;
+    static clock_t prev_time = 0;
+    POP1ARG(label);
+    // report everything dispatched since the previous BENCH
+    clock_t now = clock();
+    int64_t msgs = msg_dispatch_cnt - prev_cnt;
+    int64_t usecs = ((int64_t)(now - prev_time) * 1000000) / CLOCKS_PER_SEC;
+    printf("bench runtime=quartet workload=");
+    print_value(label);
+    printf(" msgs=%"PRId64" usecs=%"PRId64" msgs_per_sec=%"PRId64
+        " ns_per_dispatch=%"PRId64" peak_heap=%zu\n",
+        msgs, usecs, (usecs > 0) ? ((msgs * 1000000) / usecs) : 0,
+        (msgs > 0) ? ((usecs * 1000) / msgs) : 0,
+        block_peak * sizeof(int_t));
+    fflush(stdout);
+    prev_cnt = msg_dispatch_cnt;
+    prev_time = clock();
+    block_peak = block_next;
     return TRUE;
 }
 
@@ -1716,6 +2057,7 @@ int main(int argc, char const *argv[])
     }
 #endif
 
+    word_hash_init();
     printf("-- interpreter --\n");
     return (interpret() ? 0 : 1);
 }
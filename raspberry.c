@@ -20,20 +20,52 @@
 #include "serial.h"
 #include "xmodem.h"
 #include "sexpr.h"
+#include "bose.h"
 
 #define DUMP_ASCII 0  // show ascii translation of event data
+#define POISON_SAMPLE 0  // poison 1 of (2^n) released blocks (mask=2^n-1), -1=never
+#define PROFILE_SIZE 256  // behavior profile hash table entries (power of 2)
+#define PROFILE_TOP 16  // number of behaviors shown in profile report
+#define TRACE_SIZE 128  // event trace ring records (power of 2)
+#define USE_MMU_CACHE (!USE_SMP_CORES)  // identity MMU, L1 caches, branch prediction (ARM1176 only)
+#ifndef BENCH
+#define BENCH 0  // benchmark suite and sponsor_1 dispatch count (set by `make bench`)
+#endif
 
 /* Exported procedures (force full register discipline) */
 extern void k_start(u32 sp);
 extern void monitor();
+extern void profile_record(u32* actor, u32 cycles, u32 dmiss, u32 imiss);
+extern void trace_record(const u32* event);
+extern void irq_handler();
 
 extern u8 bss_start[];
+extern u8* block_end;  // top of carved block memory (mycelia.s)
 
 /* Private data structures */
 static char linebuf[256];  // line editing buffer
 static int linepos = 0;  // read position
 static int linelen = 0;  // write position
 
+struct profile {
+    u32         beh;  // behavior address, or 0 if entry unused
+    u32         events;  // number of events dispatched
+    unsigned long long cycles;  // total CPU cycles (u32 wraps in seconds)
+    unsigned long long dmiss;  // total data cache misses
+    unsigned long long imiss;  // total instruction cache misses
+};
+static struct profile profile_tbl[PROFILE_SIZE];  // behavior profile
+static u32 profile_lost = 0;  // events not recorded (table full)
+
+struct trace {
+    u32         time;  // timer_usecs() at dispatch
+    u32         target;  // target actor
+    u32         beh;  // target behavior
+    u32         msg[5];  // first 5 words of message
+};
+static struct trace trace_ring[TRACE_SIZE];  // recent events, oldest overwritten
+static u32 trace_count = 0;  // total events recorded
+
 /* Public data structures */
 const char hex[] = "0123456789abcdef";  // hexadecimal characters
 
@@ -269,6 +301,188 @@ report_time(u32 t)
     serial_eol();
 }
 
+/*
+ * Report block poisoning counts for sponsor_0 and sponsor_2
+ */
+void
+report_poison(u32* sponsor)
+{
+    serial_puts("poisoned ");
+    serial_dec32(sponsor[11]);  // sponsor table 0x2c
+    serial_puts(" skipped ");
+    serial_dec32(sponsor[12]);  // sponsor table 0x30
+    serial_eol();
+}
+
+/*
+ * Find the behavior of an actor created from one of the mycelia.s templates
+ */
+static u32
+behavior_of(u32* actor)
+{
+    u32 n = 0;
+    u32 r;
+
+    if ((u8*)actor < heap_start) {
+        return (u32)actor;  // static actor, code is behavior
+    }
+    if ((actor[0] == 0xe1a0c00f)  // mov ip, pc
+    &&  ((actor[1] & 0xFFFF8000) == 0xe89c8000)) {  // ldmia ip, {..., pc}
+        for (r = actor[1] & 0xFFFF; r; r &= (r - 1)) {
+            ++n;
+        }
+        return actor[n + 1];  // pc loaded from last field
+    }
+    if ((actor[0] & 0xFFFF8000) == 0xe99c8000) {  // ldmib ip, {..., pc}
+        for (r = actor[0] & 0xFFFF; r; r &= (r - 1)) {
+            ++n;
+        }
+        return actor[n];  // pc loaded from last field
+    }
+    if (actor[0] == 0xe59cf004) {  // ldr pc, [ip, #4]
+        return actor[1];
+    }
+    return (u32)actor;  // unknown, use actor address
+}
+
+/*
+ * Accumulate performance counts for one event (called from sponsor_5)
+ */
+void
+profile_record(u32* actor, u32 cycles, u32 dmiss, u32 imiss)
+{
+    u32 beh = behavior_of(actor);
+    u32 i = (beh >> 5) ^ (beh >> 13);
+    u32 n;
+
+    for (n = 0; n < PROFILE_SIZE; ++n) {
+        struct profile* p = &profile_tbl[(i + n) & (PROFILE_SIZE - 1)];
+        if (p->beh == 0) {
+            p->beh = beh;  // claim empty entry
+        }
+        if (p->beh == beh) {
+            ++p->events;
+            p->cycles += cycles;
+            p->dmiss += dmiss;
+            p->imiss += imiss;
+            return;
+        }
+    }
+    ++profile_lost;  // fail!
+}
+
+/*
+ * Print a 64-bit count as 16 hexadecimal digits
+ */
+static void
+profile_hex64(unsigned long long n)
+{
+    serial_hex32((u32)(n >> 32));
+    serial_hex32((u32)n);
+}
+
+/*
+ * Sort key for profile report (cache misses, or cycles)
+ */
+static unsigned long long
+profile_key(struct profile* p, int misses)
+{
+    return (misses ? (p->dmiss + p->imiss) : p->cycles);
+}
+
+/*
+ * Print behaviors with the most cycles (or cache misses), then clear the profile
+ */
+void
+profile_report(int misses)
+{
+    struct profile t;
+    int i;
+    int j;
+
+    // sort by total cycles, or total cache misses (descending)
+    for (i = 1; i < PROFILE_SIZE; ++i) {
+        t = profile_tbl[i];
+        for (j = i; (j > 0) && (profile_key(&profile_tbl[j - 1], misses) < profile_key(&t, misses)); --j) {
+            profile_tbl[j] = profile_tbl[j - 1];
+        }
+        profile_tbl[j] = t;
+    }
+    serial_puts("behavior events   cycles           d-miss           i-miss           misses");
+    serial_eol();
+    for (i = 0; (i < PROFILE_TOP) && profile_tbl[i].beh; ++i) {
+        serial_hex32(profile_tbl[i].beh);
+        serial_write(' ');
+        serial_hex32(profile_tbl[i].events);
+        serial_write(' ');
+        profile_hex64(profile_tbl[i].cycles);
+        serial_write(' ');
+        profile_hex64(profile_tbl[i].dmiss);
+        serial_write(' ');
+        profile_hex64(profile_tbl[i].imiss);
+        serial_write(' ');
+        profile_hex64(profile_tbl[i].dmiss + profile_tbl[i].imiss);
+        serial_eol();
+    }
+    if (profile_lost) {
+        serial_dec32(profile_lost);
+        serial_puts(" events not recorded");
+        serial_eol();
+    }
+    // clear profile
+    for (i = 0; i < PROFILE_SIZE; ++i) {
+        profile_tbl[i].beh = 0;
+        profile_tbl[i].events = 0;
+        profile_tbl[i].cycles = 0;
+        profile_tbl[i].dmiss = 0;
+        profile_tbl[i].imiss = 0;
+    }
+    profile_lost = 0;
+}
+
+/*
+ * Record event in trace ring, without formatting (trace hook for mycelia)
+ */
+void
+trace_record(const u32* event)
+{
+    struct trace* t = &trace_ring[trace_count & (TRACE_SIZE - 1)];
+
+    t->time = timer_usecs();
+    t->target = event[0];
+    t->beh = behavior_of((u32*)event[0]);
+    t->msg[0] = event[1];
+    t->msg[1] = event[2];
+    t->msg[2] = event[3];
+    t->msg[3] = event[4];
+    t->msg[4] = event[5];
+    ++trace_count;
+}
+
+/*
+ * Print trace ring (oldest first), one record per line, then clear it
+ */
+void
+trace_drain()
+{
+    u32 n = trace_count;
+
+    if (n > TRACE_SIZE) {
+        serial_dec32(n - TRACE_SIZE);
+        serial_puts(" older events overwritten");
+        serial_eol();
+        n = TRACE_SIZE;
+    }
+    serial_puts("     time   target behavior msg...");
+    serial_eol();
+    while (n > 0) {
+        dump_block((const u32*)&trace_ring[(trace_count - n) & (TRACE_SIZE - 1)]);
+        serial_eol();
+        --n;
+    }
+    trace_count = 0;
+}
+
 /*
  * Traditional "cooked" single-character output
  */
@@ -296,6 +510,27 @@ puts(char* s)
     }
 }
 
+/*
+ * Traditional "cooked" buffer output, written in runs between newlines
+ */
+void
+putbuf(const u8* p, int n)
+{
+    int k;
+
+    while (n > 0) {
+        for (k = 0; (k < n) && (p[k] != '\n'); ++k)
+            ;
+        serial_write_n(p, k);
+        if (k < n) {  // newline
+            serial_eol();
+            ++k;
+        }
+        p += k;
+        n -= k;
+    }
+}
+
 /*
  * Single-character "cooked" input (unbuffered)
  */
@@ -380,12 +615,51 @@ wait_for_kb()
 #define UPLOAD_ADDR     (0x00020000)
 #define UPLOAD_LIMIT    (0x0000FF00)
 
+/*
+ * Copy upload and boot (new image installs its own vectors)
+ */
+static void
+boot_upload()
+{
+    serial_eol();
+    serial_out_flush();
+    irq_disable();
+    mmu_disable();  // write back dirty lines, new image starts uncached
+    BRANCH_TO(UPLOAD_ADDR);  // should not return...
+}
+
+/*
+ * XMODEM sink staging source text for the parser
+ */
+static int
+text_sink(void* ctx, const u8* data, int n)
+{
+    int* len = ctx;
+    char* p = (char*)UPLOAD_ADDR + *len;
+    int c;
+
+    while (n-- > 0) {
+        c = *data++;
+        if (c == 0x1A) {  // SUB pads the last block
+            continue;
+        }
+        if (*len >= (UPLOAD_LIMIT - 1)) {
+            return -1;  // no room for text and NUL
+        }
+        *p++ = c;
+        ++*len;
+    }
+    *p = '\0';
+    return 0;
+}
+
 /*
  * Simple bootstrap monitor
  */
 void
 monitor()
 {
+    extern ACTOR a_kernel_repl;
     int c;
     int z = 0;
     int len = 0;
@@ -394,6 +668,10 @@ monitor()
     serial_eol();
     serial_puts("^D=exit-monitor ^Z=toggle-hexadecimal ^L=xmodem-upload");
     serial_eol();
+    serial_puts("^P=profile-report ^O=profile-by-misses ^T=trace-drain");
+    serial_eol();
+    serial_puts("^B=xmodem-boot ^E=xmodem-eval");
+    serial_eol();
 
     // echo console input to output
     for (;;) {
@@ -437,9 +715,46 @@ monitor()
                 serial_eol();
             }
         }
-        if ((c == 0x17) && (len > 0)) {  // ^W copy upload and boot
+        if (c == 0x14) {  // ^T drain event trace ring
+            serial_eol();
+            trace_drain();
+        }
+        if (c == 0x10) {  // ^P dump behavior profile (by cycles)
             serial_eol();
-            BRANCH_TO(UPLOAD_ADDR);  // should not return...
+            profile_report(0);
+        }
+        if (c == 0x0F) {  // ^O dump behavior profile (by cache misses)
+            serial_eol();
+            profile_report(1);
+        }
+        if (c == 0x02) {  // ^B xmodem upload and boot
+            serial_eol();
+            serial_puts("START XMODEM...");
+            len = rcv_xmodem((u8*)UPLOAD_ADDR, UPLOAD_LIMIT);
+            if (len > 0) {
+                boot_upload();
+            }
+            serial_eol();
+            serial_puts("UPLOAD FAILED!");
+            serial_eol();
+        }
+        if (c == 0x05) {  // ^E xmodem upload source and evaluate
+            serial_eol();
+            serial_puts("START XMODEM...");
+            len = 0;
+            *(char*)UPLOAD_ADDR = '\0';
+            if (rcv_xmodem_stream(text_sink, &len) < 0) {
+                serial_eol();
+                serial_puts("UPLOAD FAILED!");
+                serial_eol();
+            } else {
+                feed_chars((char*)UPLOAD_ADDR);
+                mycelia(&sponsor_0, &a_kernel_repl, 0);
+            }
+            len = 0;  // not a bootable image
+        }
+        if ((c == 0x17) && (len > 0)) {  // ^W copy upload and boot
+            boot_upload();
         }
     }
     serial_eol();
@@ -455,22 +770,263 @@ clear_bss()
     }
 }
 
+#define MMU_TTB_ADDR    (0x00001000)  // 1024 sections covering 0..1GB (TTBCR.N=2)
+#define MMU_PAGE_ADDR   (0x00002000)  // 256 small pages covering the first 1MB
+#define MMU_SECT_RAM    (0x00000C0A)  // AP=11, TEX=000 C=1 B=0 (write-through)
+#define MMU_SECT_DEV    (0x00000C16)  // AP=11, XN, TEX=000 C=0 B=1 (shared device)
+#define MMU_COARSE      (0x00000001)  // level-2 page table, domain 0
+#define MMU_PAGE_WB     (0x0000007E)  // AP=11, TEX=001 C=1 B=1 (write-back, allocate)
+#define MMU_PAGE_WT     (0x0000003A)  // AP=11, TEX=000 C=1 B=0 (write-through)
+
+/*
+ * Build identity-mapped translation tables and enable the MMU and L1 caches
+ *
+ * The kernel image (KERNEL_ADDR up to heap_start) is write-back cacheable.
+ * Everything else in RAM is write-through, because actor code is written
+ * into heap blocks with ordinary stores (and vectors into low memory),
+ * so instruction fetch must find it in memory.  The kernel keeps the
+ * I-cache honest by invalidating each block on `release` and draining
+ * the write buffer on `enqueue` (see mycelia.s).
+ */
+static void
+mmu_init()
+{
+#if USE_MMU_CACHE
+    u32* ttb = (u32*)MMU_TTB_ADDR;
+    u32* page = (u32*)MMU_PAGE_ADDR;
+    u32 a;
+    int n;
+
+    for (n = 0; n < 256; ++n) {
+        a = (u32)n << 12;
+        if ((a >= KERNEL_ADDR) && (a < (u32)heap_start)) {
+            page[n] = a | MMU_PAGE_WB;
+        } else {
+            page[n] = a | MMU_PAGE_WT;
+        }
+    }
+    ttb[0] = MMU_PAGE_ADDR | MMU_COARSE;
+    for (n = 1; n < 1024; ++n) {
+        a = (u32)n << 20;
+        ttb[n] = a | ((a < PERIPH_BASE) ? MMU_SECT_RAM : MMU_SECT_DEV);
+    }
+    mmu_enable(MMU_TTB_ADDR);
+#endif
+}
+
+/*
+ * Release secondary cores from the firmware spin-loop (once)
+ */
+static void
+smp_wake()
+{
+#if USE_SMP_CORES
+    extern void smp_entry();
+    static int awake = 0;
+    int n;
+
+    if (!awake) {
+        for (n = 1; n < 4; ++n) {
+            // ARM-local mailbox 3 write-set register for core n
+            PUT_32(0x4000008C + (n << 4), (u32)&smp_entry);
+        }
+        SEV();
+        awake = 1;
+    }
+#endif
+}
+
+/*
+ * Report per-core work-stealing counts for SMP sponsor
+ */
+static void
+smp_report()
+{
+    u32* sponsor = (u32*)&sponsor_3;
+    int n;
+
+    for (n = 0; n < 4; ++n) {
+        serial_puts("core ");
+        serial_dec32(n);
+        serial_puts(" stole ");
+        serial_dec32(sponsor[(n << 4) + 15]);  // per-core table 0x3c
+        serial_eol();
+    }
+}
+
+#if BENCH
+#define BENCH_BOSE_SIZE 1000  // array elements (and object properties) encoded
+#define BENCH_BOSE_REPS 10  // encode/decode round-trips
+
+/*
+ * Divide without library support (ARM1176 has no divide instruction)
+ */
+static u32
+bench_div(unsigned long long n, u32 d)
+{
+    unsigned long long r = 0;
+    u32 q = 0;
+    int i;
+
+    for (i = 0; i < 64; ++i) {
+        r = (r << 1) | (n >> 63);
+        n <<= 1;
+        q <<= 1;
+        if (r >= d) {
+            r -= d;
+            q |= 1;
+        }
+    }
+    return q;
+}
+
+/*
+ * Report one benchmark result in the line format shared with wart and quartet
+ */
+static void
+bench_report(char* workload, u32 msgs, u32 t)
+{
+    serial_puts("bench runtime=mycelia workload=");
+    serial_puts(workload);
+    serial_puts(" msgs=");
+    serial_dec32(msgs);
+    serial_puts(" usecs=");
+    serial_dec32(t);
+    serial_puts(" msgs_per_sec=");
+    serial_dec32(t ? bench_div((unsigned long long)msgs * 1000000, t) : 0);
+    serial_puts(" ns_per_dispatch=");
+    serial_dec32(msgs ? bench_div((unsigned long long)t * 1000, msgs) : 0);
+    serial_puts(" peak_heap=");
+    serial_dec32(block_end - heap_start);
+    serial_eol();
+}
+
+/*
+ * Run one actor benchmark on the fast sponsor, counting dispatched events
+ */
+static void
+bench_actor(char* workload, ACTOR* start)
+{
+    u32* sponsor = (u32*)&sponsor_1;
+    u32 t;
+
+    sponsor[6] = 0;  // sponsor table 0x18
+    timer_start();
+    mycelia(&sponsor_1, start, 0);
+    t = timer_stop();
+    bench_report(workload, sponsor[6], t);
+}
+
+/*
+ * Round-trip a large array and object through BOSE, returns values processed
+ */
+static u32
+bench_bose()
+{
+    ACTOR* ab = new_array_builder();
+    ACTOR* ob = new_object_builder();
+    ACTOR* sb;
+    ACTOR* v;
+    u8 k[4];
+    u32 n;
+
+    for (n = 0; n < BENCH_BOSE_SIZE; ++n) {
+        if (!array_append(ab, new_int((int)(n * n) - 5000))) return 0;
+        k[0] = 'k';
+        k[1] = hex[(n >> 8) & 0xF];
+        k[2] = hex[(n >> 4) & 0xF];
+        k[3] = hex[n & 0xF];
+        if (!object_append(ob, new_octets(k, sizeof(k)), new_int(n))) return 0;
+    }
+    v = new_array_builder();
+    array_append(v, get_array_built(ab));
+    array_append(v, get_object_built(ob));
+    v = get_array_built(v);  // [array, object]
+    for (n = 0; n < BENCH_BOSE_REPS; ++n) {
+        sb = new_string_builder(octets);
+        if (!encode_bose(sb, v)) break;
+        if (!decode_bose(new_string_iterator(get_string_built(sb)))) break;
+    }
+    return n * 2 * (3 * BENCH_BOSE_SIZE);  // elements, names and values, both ways
+}
+
+/*
+ * Run the benchmark suite (see bench.md)
+ */
+static void
+bench_suite()
+{
+    extern ACTOR a_bench;
+    extern ACTOR a_bench_ring;
+    extern ACTOR a_bench_tree;
+    u32 n;
+    u32 t;
+
+    bench_actor("countdown", &a_bench);
+    bench_actor("ring", &a_bench_ring);
+    bench_actor("fork_join", &a_bench_tree);
+    set_sponsor(&sponsor_1);  // BOSE values are allocated from a sponsor
+    timer_start();
+    n = bench_bose();
+    t = timer_stop();
+    bench_report("bose", n, t);
+}
+#endif /* BENCH */
+
+volatile u32 irq_due = 0;  // != 0 if interrupt handlers posted work
+
+/*
+ * Deliver events posted by interrupt handlers (called from irq_check in mycelia.s)
+ */
+void
+irq_events()
+{
+    irq_due = 0;
+    if (timer_due) {
+        timer_expire();
+    }
+    serial_rx_post();
+}
+
+/*
+ * Service pending interrupts (called from irq_entry in start.s)
+ */
+void
+irq_handler()
+{
+    u32 p1 = GET_32(IRQ_PENDING_1);
+    u32 p2 = GET_32(IRQ_PENDING_2);
+
+    if (p1 & (1 << IRQ_SYSTIMER_1)) {
+        timer_irq();
+    }
+    if ((p1 & (1 << IRQ_AUX)) || (p2 & (1 << (IRQ_UART - 32)))) {
+        serial_irq();
+    }
+}
+
 /*
  * Entry point for C code
  */
 void
 k_start(u32 sp)
 {
-    extern ACTOR a_poll;
+    extern ACTOR a_console_echo;
     extern ACTOR a_test;
     extern ACTOR a_bench;
+    extern ACTOR a_bench2;
     extern ACTOR a_kernel_repl;
     extern ACTOR a_cal_test;
     extern ACTOR a_exit;
+    extern ACTOR a_quota;
 
     // device initialization
+    clear_bss();  // before interrupts fill the serial rings
+    irq_init(USE_SMP_CORES);  // leave firmware spin-table at 0x0 for secondary cores
+    mmu_init();  // after vectors are written, caches still off
     timer_init();
     serial_init();
+    irq_enable();
 
     // wait for initial interaction
     serial_puts(";-) ");
@@ -488,7 +1044,8 @@ k_start(u32 sp)
     serial_hex32((u32)heap_start);
     serial_eol();
 
-    clear_bss();
+    ((u32*)&sponsor_0)[10] = POISON_SAMPLE;  // sponsor table 0x28
+    ((u32*)&sponsor_2)[10] = POISON_SAMPLE;
     for (;;) {
         // display menu
         serial_eol();
@@ -499,6 +1056,12 @@ k_start(u32 sp)
         serial_puts("  4. Benchmark"); serial_eol();
         serial_puts("  5. Kernel REPL"); serial_eol();
         serial_puts("  6. CAL self-test"); serial_eol();
+        serial_puts("  7. SMP benchmark"); serial_eol();
+        serial_puts("  8. Metered benchmark"); serial_eol();
+        serial_puts("  0. Profiled REPL"); serial_eol();
+#if BENCH
+        serial_puts("  b. Benchmark suite"); serial_eol();
+#endif
         serial_puts("  9. Exit"); serial_eol();
         // execute selected option
         switch (_getchar()) {
@@ -507,13 +1070,15 @@ k_start(u32 sp)
                 break;
             }
             case '2': {
-                mycelia(&sponsor_1, &a_poll, 0);
+                mycelia(&sponsor_1, &a_console_echo, 0);
                 break;
             }
             case '3': {
                 timer_start();
-                mycelia(&sponsor_0, &a_test, (u32)&dump_event);
+                mycelia(&sponsor_0, &a_test, (u32)&trace_record);  // ^T in monitor to drain
+//                mycelia(&sponsor_0, &a_test, (u32)&dump_event);  // synchronous trace
                 report_time(timer_stop());
+                report_poison((u32*)&sponsor_0);
                 break;
             }
             case '4': {
@@ -526,6 +1091,9 @@ k_start(u32 sp)
             case '5': {
                 mycelia(&sponsor_0, &a_kernel_repl, 0);
 //                mycelia(&sponsor_2, &a_kernel_repl, (u32)&dump_event);
+                serial_puts("numbers shared ");
+                serial_dec32(number_memo_saved());
+                serial_eol();
                 break;
             }
             case '6': {
@@ -533,6 +1101,34 @@ k_start(u32 sp)
 //                mycelia(&sponsor_2, &a_cal_test, (u32)&dump_event);
                 break;
             }
+            case '7': {
+                smp_wake();
+                smp_start();
+                timer_start();
+                mycelia(&sponsor_3, &a_bench2, 0);  // SMP sponsor (no tracing)
+                report_time(timer_stop());
+                smp_report();
+                break;
+            }
+            case '8': {
+                meter_init(&sponsor_4, &sponsor_1, &a_quota);
+                meter_grant(&sponsor_4, 100000, 1000, 10 secs);  // a_bench needs 1000000 events
+                timer_start();
+                mycelia(&sponsor_4, &a_bench, 0);
+                report_time(timer_stop());
+                break;
+            }
+            case '0': {
+                pmu_start();
+                mycelia(&sponsor_5, &a_kernel_repl, 0);  // ^P in monitor for report
+                break;
+            }
+#if BENCH
+            case 'b': {
+                bench_suite();
+                break;
+            }
+#endif
             case '9': {
                 mycelia(&sponsor_1, &a_exit, 0);
                 break;
@@ -41,6 +41,14 @@ extern void set_sponsor(ACTOR* sl);
 extern void sponsor_0();  // "default" sponsor
 extern void sponsor_1();  // "fast" sponsor (no trace, watchdog, etc.)
 extern void sponsor_2();  // "debug" sponsor (don't release events)
+extern void sponsor_3();  // "SMP" sponsor (per-core queues, work stealing)
+extern void smp_start();  // reset SMP sponsor and release waiting cores
+extern void sponsor_4();  // "metered" sponsor (event, block and time quotas)
+extern ACTOR* meter_init(ACTOR* sponsor, ACTOR* parent, ACTOR* handler);
+extern int meter_grant(ACTOR* sponsor, u32 events, u32 blocks, u32 usecs);
+extern void meter_enqueue(ACTOR* event, ACTOR* sponsor);  // run event under metered sponsor
+extern void sponsor_5();  // "profiling" sponsor (performance counts per behavior)
+extern void pmu_start();  // reset and enable performance counters
 
 /* kernel entry-point */
 extern void mycelia(ACTOR* sponsor, ACTOR* start, u32 trace);
@@ -51,7 +59,40 @@ extern void PUT_32(u32 addr, u32 data);
 extern u32 GET_32(u32 addr);
 extern void NO_OP();
 extern void SPIN(u32 count);
+extern void SEV();
 extern void BRANCH_TO(u32 addr);
+extern void irq_init(int vbar);  // install exception vectors (at 0x0, or VBAR if vbar) and irq stack
+extern volatile u32 irq_due;  // != 0 if interrupt handlers posted work for the dispatch path
+extern void irq_enable();
+extern u32 irq_disable();  // returns previous cpsr
+extern void irq_restore(u32 cpsr);
+extern void mmu_enable(u32 ttb);  // enable MMU, L1 caches and branch prediction
+extern void mmu_disable();  // write back dirty lines, then disable
+extern void dcache_clean_range(u32 addr, u32 len);  // before device reads memory
+extern void dcache_invalidate_range(u32 addr, u32 len);  // after device writes memory
+extern void icache_sync_range(u32 addr, u32 len);  // after writing instructions
+
+/* board selection */
+#ifndef USE_SMP_CORES
+#define USE_SMP_CORES 0  // wake cores 1..3 (BCM2836/7, Raspberry Pi 2/3 only)
+#endif
+#if USE_SMP_CORES
+#define PERIPH_BASE             (0x3F000000)  // BCM2836/7 peripherals (Raspberry Pi 2/3)
+#else
+#define PERIPH_BASE             (0x20000000)  // BCM2835 peripherals (Raspberry Pi 1)
+#endif
+
+/* BCM2835 interrupt controller */
+#define IRQ_BASE                (PERIPH_BASE + 0xB000)
+#define IRQ_PENDING_1           (IRQ_BASE + 0x204)  // irq 0..31
+#define IRQ_PENDING_2           (IRQ_BASE + 0x208)  // irq 32..63
+#define IRQ_ENABLE_1            (IRQ_BASE + 0x210)
+#define IRQ_ENABLE_2            (IRQ_BASE + 0x214)
+#define IRQ_DISABLE_1           (IRQ_BASE + 0x21C)
+#define IRQ_DISABLE_2           (IRQ_BASE + 0x220)
+#define IRQ_SYSTIMER_1          (1)  // system timer compare 1
+#define IRQ_AUX                 (29)  // mini UART
+#define IRQ_UART                (57)  // full UART (PL011)
 
 /* macros to enhance efficiency */
 #define PUT_32(addr, data)      (*((volatile u32*)(addr)) = (data))
@@ -71,11 +112,14 @@ struct example_5 {
 
 extern void* reserve();  // allocate 32-byte block -- WARNING! sponsor required
 extern void release(void* block);  // free reserved block
+extern void* reserve_n(u32 size);  // allocate 32/64/128/256-byte block, or NULL
+extern void release_n(void* block, u32 size);  // free sized block
 extern struct example_5 *create_5(ACTOR* behavior);
 
 /* C helpers from raspberry.c */
 extern int putchar(int c);
 extern void puts(char* s);
+extern void putbuf(const u8* p, int n);
 extern int getchar();
 extern void serial_hex8(u8 b);
 extern void serial_hex16(u16 d);
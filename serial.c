@@ -22,8 +22,9 @@
 
 #define USE_SERIAL_UART0    /* select full UART for serial i/o */
 //#define USE_SERIAL_UART1    /* select mini UART for serial i/o */
+#define USE_SERIAL_IRQ      /* interrupt-driven i/o through RX/TX rings */
 
-#define GPIO_BASE       0x20200000
+#define GPIO_BASE       (PERIPH_BASE + 0x200000)
 #define GPFSEL1         (*((volatile u32*)(GPIO_BASE + 0x04)))
 #define GPSET0          (*((volatile u32*)(GPIO_BASE + 0x1c)))
 #define GPCLR0          (*((volatile u32*)(GPIO_BASE + 0x28)))
@@ -51,7 +52,7 @@ struct uart0 {
     u32         ICR;    //_44;
     u32         DMACR;  //_48;
 };
-#define UART0           ((volatile struct uart0 *)0x20201000)
+#define UART0           ((volatile struct uart0 *)(PERIPH_BASE + 0x201000))
 
 struct uart1 {
     u32         _00;
@@ -82,7 +83,25 @@ struct uart1 {
     u32         STAT;   //_64;
     u32         BAUD;   //_68;
 };
-#define UART1           ((volatile struct uart1 *)0x20215000)
+#define UART1           ((volatile struct uart1 *)(PERIPH_BASE + 0x215000))
+
+#ifdef USE_SERIAL_IRQ
+#define RX_RING_SIZE    2048    /* received-character ring (power of 2) */
+#define TX_RING_SIZE    256     /* transmit-character ring (power of 2) */
+
+static u8 rx_ring[RX_RING_SIZE];
+static volatile u32 rx_head = 0;  // next write (irq)
+static volatile u32 rx_tail = 0;  // next read
+static u8 tx_ring[TX_RING_SIZE];
+static volatile u32 tx_head = 0;  // next write
+static volatile u32 tx_tail = 0;  // next read (irq)
+static u32 rx_dropped = 0;  // characters lost (rx ring full)
+static ACTOR* rx_wait_to = NULL;  // actor waiting for input, or NULL
+static u32 rx_wait_1;  // message for waiting actor
+static u32 rx_wait_2;
+#endif /* USE_SERIAL_IRQ */
+
+extern void send_2(ACTOR* target, u32 msg_1, u32 msg_2);
 
 /*
  * Initialize serial UART to use GPIO pins 14 (TX) and 15 (RX)
@@ -113,6 +132,11 @@ serial_init()
     UART0->IBRD = 1;
     UART0->FBRD = 40;
     UART0->LCRH = 0x70;
+#ifdef USE_SERIAL_IRQ
+    UART0->IFLS = 0;            // interrupt at 1/8 fifo level
+    UART0->IMSC = 0x50;         // receive and receive-timeout interrupts
+    PUT_32(IRQ_ENABLE_2, 1 << (IRQ_UART - 32));
+#endif /* USE_SERIAL_IRQ */
     UART0->CR = 0x301;
 #endif /* USE_SERIAL_UART0 */
 #ifdef USE_SERIAL_UART1
@@ -145,15 +169,19 @@ serial_init()
     UART1->BAUD = 270;
 
     SPIN(250);                  // wait for (at least) 250 clock cycles
+#ifdef USE_SERIAL_IRQ
+    UART1->IER = 0x05;          // receive interrupt (bit 2 required, see errata)
+    PUT_32(IRQ_ENABLE_1, 1 << IRQ_AUX);
+#endif /* USE_SERIAL_IRQ */
     UART1->CNTL = 3;
 #endif /* USE_SERIAL_UART1 */
 }
 
 /*
- * Serial input ready != 0, wait == 0
+ * UART input ready != 0, wait == 0
  */
-int
-serial_in_ready()
+static int
+uart_in_ready()
 {
 #ifdef USE_SERIAL_UART0
     return (UART0->FR & 0x10) == 0;
@@ -164,10 +192,10 @@ serial_in_ready()
 }
 
 /*
- * Raw input from serial port
+ * Raw input from UART
  */
-int
-serial_in()
+static int
+uart_in()
 {
 #ifdef USE_SERIAL_UART0
     return UART0->DR & 0xff;
@@ -178,20 +206,10 @@ serial_in()
 }
 
 /*
- * Consume input until !ready
+ * UART output ready != 0, wait == 0
  */
-void
-serial_in_flush() {
-    while (serial_in_ready()) {
-        serial_in();
-    }
-}
-
-/*
- * Serial output ready != 0, wait == 0
- */
-int
-serial_out_ready()
+static int
+uart_out_ready()
 {
 #ifdef USE_SERIAL_UART0
     return (UART0->FR & 0x20) == 0;
@@ -202,10 +220,10 @@ serial_out_ready()
 }
 
 /*
- * Raw output to serial port
+ * Raw output to UART
  */
-int
-serial_out(u8 data)
+static int
+uart_out(u8 data)
 {
 #ifdef USE_SERIAL_UART0
     UART0->DR = (u32)data;
@@ -217,6 +235,236 @@ serial_out(u8 data)
 #endif /* USE_SERIAL_UART1 */
 }
 
+#ifdef USE_SERIAL_IRQ
+/*
+ * Enable (or disable) UART transmit interrupt
+ */
+static void
+uart_tx_irq(int on)
+{
+#ifdef USE_SERIAL_UART0
+    if (on) {
+        UART0->IMSC |= 0x20;
+    } else {
+        UART0->IMSC &= ~0x20;
+    }
+#endif /* USE_SERIAL_UART0 */
+#ifdef USE_SERIAL_UART1
+    if (on) {
+        UART1->IER |= 0x02;
+    } else {
+        UART1->IER &= ~0x02;
+    }
+#endif /* USE_SERIAL_UART1 */
+}
+
+/*
+ * Move received characters from UART into rx ring
+ */
+static void
+rx_pump()
+{
+    int c;
+
+    while (uart_in_ready()) {
+        c = uart_in();
+        if ((rx_head - rx_tail) < RX_RING_SIZE) {
+            rx_ring[rx_head & (RX_RING_SIZE - 1)] = (u8)c;
+            ++rx_head;
+        } else {
+            ++rx_dropped;
+        }
+    }
+    if (rx_wait_to && (rx_head != rx_tail)) {
+        irq_due = 1;  // notify waiter on the dispatch path
+    }
+}
+
+/*
+ * Move pending characters from tx ring into UART
+ */
+static void
+tx_pump()
+{
+    while ((tx_tail != tx_head) && uart_out_ready()) {
+        uart_out(tx_ring[tx_tail & (TX_RING_SIZE - 1)]);
+        ++tx_tail;
+    }
+    uart_tx_irq(tx_tail != tx_head);  // interrupt when fifo drains
+}
+#endif /* USE_SERIAL_IRQ */
+
+/*
+ * Service UART interrupt (called from irq_handler)
+ */
+void
+serial_irq()
+{
+#ifdef USE_SERIAL_IRQ
+#ifdef USE_SERIAL_UART0
+    UART0->ICR = 0x70;          // clear rx, tx and rx-timeout interrupts
+#endif /* USE_SERIAL_UART0 */
+    rx_pump();
+    tx_pump();
+#endif /* USE_SERIAL_IRQ */
+}
+
+/*
+ * Count of characters lost because the rx ring was full
+ */
+u32
+serial_rx_dropped()
+{
+#ifdef USE_SERIAL_IRQ
+    return rx_dropped;
+#else
+    return 0;
+#endif /* USE_SERIAL_IRQ */
+}
+
+/*
+ * Send (msg_1, msg_2) to target once input is ready (one waiter at a time)
+ */
+void
+serial_rx_wait(ACTOR* target, u32 msg_1, u32 msg_2)
+{
+#ifdef USE_SERIAL_IRQ
+    u32 cpsr;
+
+    cpsr = irq_disable();
+    rx_pump();
+    if (rx_head == rx_tail) {  // wait for rx interrupt
+        rx_wait_to = target;
+        rx_wait_1 = msg_1;
+        rx_wait_2 = msg_2;
+        irq_restore(cpsr);
+        return;
+    }
+    irq_restore(cpsr);
+#endif /* USE_SERIAL_IRQ */
+    send_2(target, msg_1, msg_2);  // input ready (or no interrupts, so poll)
+}
+
+/*
+ * Notify the input waiter, if input has arrived (called from irq_events)
+ */
+void
+serial_rx_post()
+{
+#ifdef USE_SERIAL_IRQ
+    ACTOR* target = rx_wait_to;
+
+    if (target && (rx_head != rx_tail)) {
+        rx_wait_to = NULL;
+        send_2(target, rx_wait_1, rx_wait_2);
+    }
+#endif /* USE_SERIAL_IRQ */
+}
+
+/*
+ * Serial input ready != 0, wait == 0
+ */
+int
+serial_in_ready()
+{
+#ifdef USE_SERIAL_IRQ
+    u32 cpsr;
+
+    if (rx_head == rx_tail) {  // poll, in case interrupts are disabled
+        cpsr = irq_disable();
+        rx_pump();
+        irq_restore(cpsr);
+    }
+    return (rx_head != rx_tail);
+#else
+    return uart_in_ready();
+#endif /* USE_SERIAL_IRQ */
+}
+
+/*
+ * Raw input from serial port
+ */
+int
+serial_in()
+{
+#ifdef USE_SERIAL_IRQ
+    int c;
+
+    c = rx_ring[rx_tail & (RX_RING_SIZE - 1)];
+    ++rx_tail;
+    return c;
+#else
+    return uart_in();
+#endif /* USE_SERIAL_IRQ */
+}
+
+/*
+ * Serial output ready != 0, wait == 0
+ */
+int
+serial_out_ready()
+{
+#ifdef USE_SERIAL_IRQ
+    u32 cpsr;
+
+    if ((tx_head - tx_tail) >= TX_RING_SIZE) {  // poll, in case interrupts are disabled
+        cpsr = irq_disable();
+        tx_pump();
+        irq_restore(cpsr);
+    }
+    return ((tx_head - tx_tail) < TX_RING_SIZE);
+#else
+    return uart_out_ready();
+#endif /* USE_SERIAL_IRQ */
+}
+
+/*
+ * Raw output to serial port
+ */
+int
+serial_out(u8 data)
+{
+#ifdef USE_SERIAL_IRQ
+    u32 cpsr;
+
+    tx_ring[tx_head & (TX_RING_SIZE - 1)] = data;
+    ++tx_head;
+    cpsr = irq_disable();
+    tx_pump();  // prime fifo, so drain interrupt will follow
+    irq_restore(cpsr);
+    return (int)data;
+#else
+    return uart_out(data);
+#endif /* USE_SERIAL_IRQ */
+}
+
+/*
+ * Consume input until !ready
+ */
+void
+serial_in_flush() {
+    while (serial_in_ready()) {
+        serial_in();
+    }
+}
+
+/*
+ * Wait until buffered output has been sent
+ */
+void
+serial_out_flush()
+{
+#ifdef USE_SERIAL_IRQ
+    u32 cpsr;
+
+    while (tx_head != tx_tail) {  // poll, in case interrupts are disabled
+        cpsr = irq_disable();
+        tx_pump();
+        irq_restore(cpsr);
+    }
+#endif /* USE_SERIAL_IRQ */
+}
+
 /*
  * Blocking read from serial port
  */
@@ -239,6 +487,37 @@ serial_write(u8 data)
     return serial_out(data);
 }
 
+/*
+ * Blocking write of n octets, queued in bulk
+ */
+int
+serial_write_n(const u8* p, int n)
+{
+#ifdef USE_SERIAL_IRQ
+    u32 cpsr;
+    int k = 0;
+
+    while (k < n) {
+        while (!serial_out_ready())
+            ;
+        while ((k < n) && ((tx_head - tx_tail) < TX_RING_SIZE)) {
+            tx_ring[tx_head & (TX_RING_SIZE - 1)] = p[k++];
+            ++tx_head;
+        }
+        cpsr = irq_disable();
+        tx_pump();  // prime fifo, so drain interrupt will follow
+        irq_restore(cpsr);
+    }
+#else
+    int k;
+
+    for (k = 0; k < n; ++k) {
+        serial_write(p[k]);
+    }
+#endif /* USE_SERIAL_IRQ */
+    return n;
+}
+
 /*
  * Print a C-string, character-by-character
  */
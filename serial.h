@@ -26,9 +26,15 @@ extern int      serial_in();                /* raw input from serial port */
 extern void     serial_in_flush();          /* consume input until !ready */
 extern int      serial_out_ready();         /* output ready != 0, wait == 0 */
 extern int      serial_out(u8 data);        /* raw output to serial port */
+extern void     serial_out_flush();         /* wait until output is sent */
+extern void     serial_irq();               /* service UART interrupt */
+extern u32      serial_rx_dropped();        /* input lost to rx ring overflow */
+extern void     serial_rx_wait(ACTOR* target, u32 msg_1, u32 msg_2); /* send msg once input is ready */
+extern void     serial_rx_post();           /* notify input waiter, if input arrived */
 
 extern int      serial_read();              /* blocking read from serial port */
 extern int      serial_write(u8 data);      /* blocking write to serial port */
+extern int      serial_write_n(const u8* p, int n); /* blocking write of n octets */
 
 extern void     serial_puts(char* s);       /* print C-string to serial port */
 extern void     serial_rep(int c, int n);   /* print n repetitions of c */
@@ -245,21 +245,98 @@ cmp_24b(struct sym_24b* x, struct sym_24b* y)
     return (x->data_18 - y->data_18);
 }
 
-static struct example_5* sym_table[1024];
-static struct example_5** next_sym = sym_table;
+#define SYM_SEG_SLOTS   (64)    // symbol slots per 256-byte heap block
+#define SYM_SEG_MIN     (4)     // initial segments (256 slots)
+#define SYM_SEG_MAX     (128)   // maximum segments (8192 slots)
 
-ACTOR*
-sym_search(struct sym_24b* name)  // search for interned symbol
+static ACTOR** sym_seg[SYM_SEG_MAX];  // open-addressed hash table, in segments
+static u32 sym_slots = 0;  // total slots (power of 2), 0 until first symbol
+static u32 sym_count = 0;  // number of interned symbols
+
+#define SYM_SLOT(i)     (&sym_seg[(i) / SYM_SEG_SLOTS][(i) % SYM_SEG_SLOTS])
+
+static u32
+hash_24b(struct sym_24b* x)
+{
+    u32 h;
+
+    h = x->data_04 * 0x9E3779B1;
+    h = (h ^ x->data_08) * 0x9E3779B1;
+    h = (h ^ x->data_0c) * 0x9E3779B1;
+    h = (h ^ x->data_10) * 0x9E3779B1;
+    h = (h ^ x->data_14) * 0x9E3779B1;
+    h = (h ^ x->data_18) * 0x9E3779B1;
+    return h ^ (h >> 16);
+}
+
+static ACTOR**  // Return slot holding name, or the empty slot where it belongs.
+sym_probe(struct sym_24b* name)
 {
-    struct example_5** sp = sym_table;
+    u32 mask = sym_slots - 1;
+    u32 i = hash_24b(name) & mask;
+    ACTOR** sp;
 
-    while (sp < next_sym) {
-        if (eq_24b(name, (struct sym_24b*)&((*sp)->data_04))) {
-            return (ACTOR*)(*sp);
+    for (;;) {
+        sp = SYM_SLOT(i);
+        if ((*sp == NULL)
+        ||  eq_24b(name, (struct sym_24b*)&((struct example_5*)(*sp))->data_04)) {
+            return sp;
         }
-        ++sp;
+        i = (i + 1) & mask;  // linear probing
     }
-    return NULL;  // not found
+}
+
+static int  // Return 1 if the table has been doubled, otherwise 0.
+sym_grow()
+{
+    ACTOR** old[SYM_SEG_MAX / 2];
+    u32 old_segs = sym_slots / SYM_SEG_SLOTS;
+    u32 segs = (old_segs ? (old_segs << 1) : SYM_SEG_MIN);
+    ACTOR* x;
+    u32 i;
+    u32 j;
+
+    if (segs > SYM_SEG_MAX) return 0;  // fail -- table at maximum size
+    for (i = 0; i < old_segs; ++i) {
+        old[i] = sym_seg[i];
+    }
+    for (i = 0; i < segs; ++i) {
+        sym_seg[i] = reserve_n(SYM_SEG_SLOTS * sizeof(ACTOR*));
+        if (sym_seg[i] == NULL) {  // out of memory, keep previous table
+            while (i-- > 0) {
+                release_n(sym_seg[i], SYM_SEG_SLOTS * sizeof(ACTOR*));
+            }
+            for (i = 0; i < old_segs; ++i) {
+                sym_seg[i] = old[i];
+            }
+            return 0;  // fail
+        }
+        for (j = 0; j < SYM_SEG_SLOTS; ++j) {
+            sym_seg[i][j] = NULL;
+        }
+    }
+    sym_slots = segs * SYM_SEG_SLOTS;
+    for (i = 0; i < old_segs; ++i) {  // re-hash symbols into new table
+        for (j = 0; j < SYM_SEG_SLOTS; ++j) {
+            if ((x = old[i][j]) != NULL) {
+                *sym_probe((struct sym_24b*)&((struct example_5*)x)->data_04) = x;
+            }
+        }
+        release_n(old[i], SYM_SEG_SLOTS * sizeof(ACTOR*));
+    }
+    TRACE(puts("sym:slots="));
+    TRACE(serial_dec32(sym_slots));
+    TRACE(putchar('\n'));
+    return 1;
+}
+
+ACTOR*
+sym_search(struct sym_24b* name)  // search for interned symbol
+{
+    if (sym_slots == 0) {
+        return NULL;  // empty table
+    }
+    return *sym_probe(name);  // NULL if not found
 }
 
 ACTOR*
@@ -271,18 +348,17 @@ symbol(struct sym_24b* name)
         TRACE(puts("sym:found\n"));
         return x;  // symbol found, return it
     }
-    int mem = ((void *)(next_sym) - (void *)(sym_table));
-    TRACE(puts("sym:mem="));
-    TRACE(serial_dec32((u32)mem));
-    TRACE(puts(",syms=0x"));
-    TRACE(serial_hex32((u32)sym_table));
-    TRACE(puts(",next=0x"));
-    TRACE(serial_hex32((u32)next_sym));
+    TRACE(puts("sym:count="));
+    TRACE(serial_dec32(sym_count));
+    TRACE(puts(",slots="));
+    TRACE(serial_dec32(sym_slots));
     TRACE(putchar('\n'));
-    if (mem >= sizeof(sym_table)) {
-        DEBUG(puts("sym:overflow\n"));
-        panic();  // FIXME: is there a better way to handle this error?
-        return NULL;  // fail -- symbol table overflow!
+    if (((sym_count + 1) << 2) > (sym_slots * 3)) {  // keep load factor <= 3/4
+        if (!sym_grow()) {
+            DEBUG(puts("sym:overflow\n"));
+            panic();  // FIXME: is there a better way to handle this error?
+            return NULL;  // fail -- symbol table overflow!
+        }
     }
     // create a new symbol
     struct example_5 *a = create_5(&b_symbol);
@@ -293,7 +369,8 @@ symbol(struct sym_24b* name)
         a->data_10 = name->data_10;
         a->data_14 = name->data_14;
         a->data_18 = name->data_18;
-        *next_sym++ = a;  // intern symbol in table
+        *sym_probe(name) = (ACTOR*)a;  // intern symbol in table
+        ++sym_count;
         TRACE(puts("sym:created="));
         TRACE(print_sexpr((ACTOR*)a));
         TRACE(putchar('\n'));
@@ -303,15 +380,56 @@ symbol(struct sym_24b* name)
     return NULL;  // fail
 }
 
+#define NUM_MEMO_MIN    (-128)  // smallest shared number
+#define NUM_MEMO_MAX    (1023)  // largest shared number
+#define NUM_MEMO_SLOTS  (64)    // number pointers per 256-byte heap block
+
+static ACTOR** num_memo[((NUM_MEMO_MAX - NUM_MEMO_MIN) / NUM_MEMO_SLOTS) + 1];
+static u32 num_memo_saved = 0;  // allocations avoided by sharing
+
+u32
+number_memo_saved()
+{
+    return num_memo_saved;
+}
+
 ACTOR*
 number(int n)
 {
-    // FIXME: consider a memo-table for small integers
+    ACTOR** memo = NULL;
+    u32 i;
+
     TRACE(puts("number(0x"));
     TRACE(serial_hex32((u32)n));
     TRACE(puts(")="));
+    if ((n >= NUM_MEMO_MIN) && (n <= NUM_MEMO_MAX)) {  // numbers are immutable
+        i = (u32)(n - NUM_MEMO_MIN);
+        if (!num_memo[i / NUM_MEMO_SLOTS]) {  // allocate memo block on demand
+            memo = reserve_n(NUM_MEMO_SLOTS * sizeof(ACTOR*));
+            if (memo) {
+                int j;
+                for (j = 0; j < NUM_MEMO_SLOTS; ++j) {
+                    memo[j] = NULL;
+                }
+                num_memo[i / NUM_MEMO_SLOTS] = memo;
+            }
+        }
+        if ((memo = num_memo[i / NUM_MEMO_SLOTS]) != NULL) {
+            memo += (i % NUM_MEMO_SLOTS);
+            if (*memo) {
+                ++num_memo_saved;
+                TRACE(puts("0x"));
+                TRACE(serial_hex32((u32)*memo));
+                TRACE(putchar('\n'));
+                return *memo;  // shared number
+            }
+        }
+    }
     struct example_5 *x = create_5(&b_number);
     x->data_04 = (u32)n;
+    if (memo) {
+        *memo = (ACTOR*)x;  // share from now on
+    }
     TRACE(puts("0x"));
     TRACE(serial_hex32((u32)x));
     TRACE(putchar('\n'));
@@ -502,6 +620,7 @@ num_reduce(int acc, NUM_OP* op, ACTOR* list)  // apply binary operator to number
  */
 static int no_print = 1;  // option to suppress printing of evaluation results
 static char* line = NULL;  // sexpr parser input source
+static char* feed = NULL;  // text to parse before further console input
 
 void
 flush_char()
@@ -510,6 +629,24 @@ flush_char()
     line = NULL;
 }
 
+/*
+ * Input available without waiting != 0, wait == 0
+ */
+int
+char_ready()
+{
+    return (line && line[0]) || feed || serial_in_ready();
+}
+
+/*
+ * Parse NUL-terminated text (e.g.: uploaded source) before console input
+ */
+void
+feed_chars(char* text)
+{
+    feed = text;
+}
+
 void close_env();  // FORWARD DECL
 
 static int
@@ -522,7 +659,12 @@ read_char()
 #endif
             no_print = 0;  // enable printing of evaluation results
         }
-        line = editline();
+        if (feed) {
+            line = feed;
+            feed = NULL;
+        } else {
+            line = editline();
+        }
         if (!line) return EOF;
     }
     int c = *line++;
@@ -1074,42 +1216,93 @@ cmp_symbol(ACTOR* r, ACTOR* s)
     return d;
 }
 
-ACTOR*
-splay_search(ACTOR* env, ACTOR* name)
+/*
+ * Top-down splay (Sleator & Tarjan), bringing the binding for name,
+ * or the last binding visited if name is absent, to the root.
+ */
+static ACTOR*
+splay(ACTOR* root, ACTOR* name)
 {
-    if (!env) {  // not found, return NULL
-        return NULL;
+    struct example_5 n;  // temporary tree header
+    struct example_5* l = &n;  // rightmost node of left tree
+    struct example_5* r = &n;  // leftmost node of right tree
+    struct example_5* t = (struct example_5*)root;
+    struct example_5* y;
+
+    n.data_10 = (u32)NULL;
+    n.data_14 = (u32)NULL;
+    for (;;) {
+        if (name == (ACTOR*)(t->data_04)) {  // interned symbols are unique
+            break;
+        }
+        if (cmp_symbol(name, (ACTOR*)(t->data_04)) < 0) {
+            // name < t.name
+            y = (struct example_5*)(t->data_10);
+            if (!y) break;
+            if ((name != (ACTOR*)(y->data_04))
+            &&  (cmp_symbol(name, (ACTOR*)(y->data_04)) < 0)) {
+                // zig-zig: rotate right
+                t->data_10 = y->data_14;  // t.left := y.right
+                y->data_14 = (u32)t;  // y.right := t
+                t = y;
+                if (!t->data_10) break;
+            }
+            // link right
+            r->data_10 = (u32)t;
+            r = t;
+            t = (struct example_5*)(t->data_10);
+        } else {
+            // name > t.name
+            y = (struct example_5*)(t->data_14);
+            if (!y) break;
+            if ((name != (ACTOR*)(y->data_04))
+            &&  (cmp_symbol(name, (ACTOR*)(y->data_04)) > 0)) {
+                // zag-zag: rotate left
+                t->data_14 = y->data_10;  // t.right := y.left
+                y->data_10 = (u32)t;  // y.left := t
+                t = y;
+                if (!t->data_14) break;
+            }
+            // link left
+            l->data_14 = (u32)t;
+            l = t;
+            t = (struct example_5*)(t->data_14);
+        }
     }
+    // assemble
+    l->data_14 = t->data_10;  // l.right := t.left
+    r->data_10 = t->data_14;  // r.left := t.right
+    t->data_10 = n.data_14;  // t.left := left tree
+    t->data_14 = n.data_10;  // t.right := right tree
+    return (ACTOR*)t;
+}
+
+ACTOR*
+splay_search(ACTOR* env, ACTOR* name)  // return new root, or NULL (tree unchanged)
+{
     struct example_5* e = (struct example_5*)env;  // root e
-    ACTOR* s = (ACTOR*)(e->data_04);  // e.name
-    if (name == s) {  // interned symbols are unique
-        // name == e.name
-        TRACE(puts("["));
-        TRACE(print_sexpr(name));
-        TRACE(puts("]="));
-        TRACE(print_sexpr(env));
-        TRACE(putchar('\n'));
-        return env;  // return match
-    }
-    ACTOR* a = NULL;  // return value
-    // zig rotation toward root
-    if (cmp_symbol(name, s) < 0) {
-        // name < e.name
-        a = splay_search((ACTOR*)e->data_10, name);  // recurse left
-        if (!a) return NULL;  // failed, return NULL
-        struct example_5* x = (struct example_5*)a;
-        e->data_10 = x->data_14;  // e.left := a.right
-        x->data_14 = (u32)e;  // a.right := e
-    } else {
-        // name > e.name
-        a = splay_search((ACTOR*)e->data_14, name);  // recurse right
-        if (!a) return NULL;  // failed, return NULL
-        struct example_5* x = (struct example_5*)a;
-        e->data_14 = x->data_10;  // e.right := a.left
-        x->data_10 = (u32)e;  // a.left := e
+    ACTOR* s;
+
+    while (e) {  // find binding without restructuring
+        s = (ACTOR*)(e->data_04);  // e.name
+        if (name == s) {  // interned symbols are unique
+            TRACE(puts("["));
+            TRACE(print_sexpr(name));
+            TRACE(puts("]="));
+            TRACE(print_sexpr((ACTOR*)e));
+            TRACE(putchar('\n'));
+            if ((ACTOR*)e == env) {
+                return env;  // already at root
+            }
+            return splay(env, name);  // move match to root
+        }
+        if (cmp_symbol(name, s) < 0) {
+            e = (struct example_5*)(e->data_10);  // search left
+        } else {
+            e = (struct example_5*)(e->data_14);  // search right
+        }
     }
-    // FIXME: consider adding zig-zig and zig-zag to implement a proper splay tree
-    return a;
+    return NULL;  // not found
 }
 
 #if 0
@@ -1128,36 +1321,31 @@ splay_key(ACTOR* name, ACTOR* value)
 #endif
 
 static ACTOR*
-splay_update(ACTOR* env, ACTOR* key)
+splay_update(ACTOR* env, ACTOR* key)  // return new root (key, unless a duplicate)
 {
-    if (!env) {  // not found, return key
+    if (!env) {  // empty tree, key becomes root
         return key;
     }
     struct example_5* x = (struct example_5*)key;  // search key
     ACTOR* r = (ACTOR*)(x->data_04);  // name
-    struct example_5* e = (struct example_5*)env;  // root e
+    struct example_5* e = (struct example_5*)splay(env, r);  // root e
     ACTOR* s = (ACTOR*)(e->data_04);  // e.name
     if (r == s) {  // interned symbols are unique
         // name == e.name
-        return env;  // return match
+        return (ACTOR*)e;  // return match
     }
-    ACTOR* a = NULL;  // return value
-    // zig rotation toward root
     if (cmp_symbol(r, s) < 0) {
         // name < e.name
-        a = splay_update((ACTOR*)e->data_10, key);  // recurse left
-        x = (struct example_5*)a;
-        e->data_10 = x->data_14;  // e.left := a.right
-        x->data_14 = (u32)e;  // a.right := e
+        x->data_10 = e->data_10;  // x.left := e.left
+        x->data_14 = (u32)e;  // x.right := e
+        e->data_10 = (u32)NULL;  // e.left := NULL
     } else {
         // name > e.name
-        a = splay_update((ACTOR*)e->data_14, key);  // recurse right
-        x = (struct example_5*)a;
-        e->data_14 = x->data_10;  // e.right := a.left
-        x->data_10 = (u32)e;  // a.left := e
+        x->data_14 = e->data_14;  // x.right := e.right
+        x->data_10 = (u32)e;  // x.left := e
+        e->data_14 = (u32)NULL;  // e.right := NULL
     }
-    // FIXME: consider adding zig-zig and zig-zag to implement a proper splay tree
-    return a;
+    return key;
 }
 
 void
@@ -22,6 +22,8 @@
 
 extern ACTOR*	match_param_tree(ACTOR* def, ACTOR* arg, ACTOR* env);  /* extend env binding args to def */
 extern ACTOR*   parse_sexpr();  /* parse and return s-expression */
+extern void     feed_chars(char* text);  /* parse text before console input */
 extern void     print_sexpr(ACTOR*);  /* print external representation of s-expression */
+extern u32      number_memo_saved();  /* number allocations avoided by sharing */
 
 #endif /* _SEXPR_H_ */
@@ -46,6 +46,48 @@ _start:
 halt:
 	b	halt		@ Full stop
 
+@ smp_entry is where secondary cores (Raspberry Pi 2/3) start, see smp_wake()
+	.text
+	.align 2
+	.global smp_entry
+smp_entry:
+	mrc	p15, 0, r0, c0, c0, 5 @ Read MPIDR
+	and	r0, r0, #3	@ Core number (1..3)
+	ldr	r1, =0x7000	@ Secondary stacks below bootstrap stack
+	sub	sp, r1, r0, LSL #12 @ 4k per core (core 1 at 0x6000)
+	ldr	lr, =halt	@ Halt on "return"
+	b	smp_core	@ Wait for SMP dispatch (r0=core)
+
+@ Exception vectors, copied to 0x00000000 by irq_init
+	.text
+	.align 5
+_vectors:
+	ldr	pc, _v_reset	@ 0x00: Reset
+	ldr	pc, _v_undef	@ 0x04: Undefined instruction
+	ldr	pc, _v_swi	@ 0x08: Software interrupt
+	ldr	pc, _v_pabort	@ 0x0c: Prefetch abort
+	ldr	pc, _v_dabort	@ 0x10: Data abort
+	ldr	pc, _v_unused	@ 0x14: (reserved)
+	ldr	pc, _v_irq	@ 0x18: IRQ
+	ldr	pc, _v_fiq	@ 0x1c: FIQ
+_v_reset:	.int	_start
+_v_undef:	.int	halt
+_v_swi:		.int	halt
+_v_pabort:	.int	halt
+_v_dabort:	.int	halt
+_v_unused:	.int	halt
+_v_irq:		.int	irq_entry
+_v_fiq:		.int	halt
+
+@ irq_entry saves the interrupted context and calls irq_handler() in C
+	.text
+	.align 2
+irq_entry:
+	sub	lr, lr, #4	@ Return address
+	stmdb	sp!, {r0-r3,ip,lr} @ Save registers not preserved by C
+	bl	irq_handler	@ Service pending interrupts
+	ldmia	sp!, {r0-r3,ip,pc}^ @ Restore registers and cpsr
+
 @@
 @@ Provide a few assembly-language helpers used by C code, e.g.: raspberry.c
 @@
@@ -70,8 +112,133 @@ GET_32:			@ u32 GET_32(u32 addr);
 BRANCH_TO:		@ void BRANCH_TO(u32 addr);
 	bx	r0
 
+	.globl SEV
+SEV:			@ void SEV();
+	.int	0xe320f004	@ sev (wake cores waiting in wfe)
+	bx	lr
+
 	.globl SPIN
 SPIN:			@ void SPIN(u32 count);
 	subs	r0, #1		@ decrement count
 	bge	SPIN		@ until negative
 	bx	lr
+
+	.globl irq_init
+irq_init:		@ void irq_init(int vbar); install vectors and IRQ stack
+	ldr	r1, =_vectors	@ Vector table (and addresses)
+	teq	r0, #0		@ If vbar (Raspberry Pi 2/3)
+	mcrne	p15, 0, r1, c12, c0, 0 @ Point VBAR at table, 0x0 holds firmware spin-table
+	bne	2f
+	mov	r2, #0		@ Hardware vector base
+	mov	r3, #16		@ Copy 16 words
+1:	ldr	ip, [r1], #4	@ Read word
+	str	ip, [r2], #4	@ Write word
+	subs	r3, #1		@ Decrement count
+	bgt	1b		@ More to copy?
+2:	mrs	r0, cpsr	@ Save current mode
+	bic	r1, r0, #0x1F	@ Clear mode bits
+	orr	r1, r1, #0xD2	@ IRQ mode, IRQ and FIQ disabled
+	msr	cpsr_c, r1	@ Switch to IRQ mode
+	ldr	sp, =0x3000	@ IRQ stack below secondary core stacks
+	msr	cpsr_c, r0	@ Restore previous mode
+	bx	lr
+
+	.globl irq_enable
+irq_enable:		@ void irq_enable();
+	mrs	r0, cpsr
+	bic	r0, r0, #0x80	@ Clear I bit
+	msr	cpsr_c, r0
+	bx	lr
+
+	.globl irq_disable
+irq_disable:		@ u32 irq_disable(); returns previous cpsr
+	mrs	r0, cpsr
+	orr	r1, r0, #0x80	@ Set I bit
+	msr	cpsr_c, r1
+	bx	lr
+
+	.globl irq_restore
+irq_restore:		@ void irq_restore(u32 cpsr);
+	msr	cpsr_c, r0	@ Restore previous I bit
+	bx	lr
+
+@@
+@@ MMU and cache control (ARM1176), see mmu_init() in raspberry.c
+@@
+	.text
+	.align 2
+
+	.globl mmu_enable
+mmu_enable:		@ void mmu_enable(u32 ttb); enable MMU, caches, prediction
+	mov	r1, #0		@ zero
+	mcr	p15, 0, r1, c7, c7, 0 @ invalidate I/D caches and BTAC
+	mcr	p15, 0, r1, c8, c7, 0 @ invalidate TLBs
+	mcr	p15, 0, r1, c7, c10, 4 @ data synchronization barrier
+	mov	r1, #0x22	@ TTBR0 maps 0..1GB (N=2), no TTBR1 walks (PD1)
+	mcr	p15, 0, r1, c2, c0, 2 @ write TTBCR
+	mcr	p15, 0, r0, c2, c0, 0 @ write TTBR0 (table walks uncached)
+	ldr	r1, =0x55555555	@ client access, check permissions and XN
+	mcr	p15, 0, r1, c3, c0, 0 @ write domain access control
+	mrc	p15, 0, r1, c1, c0, 0 @ read control register
+	ldr	r2, =0x00801805	@ XP | I | Z | C | M
+	orr	r1, r1, r2	@ ARMv6 descriptors, I-cache, prediction, D-cache, MMU
+	mcr	p15, 0, r1, c1, c0, 0 @ write control register
+	mov	r1, #0		@ zero
+	mcr	p15, 0, r1, c7, c5, 4 @ flush prefetch buffer
+	bx	lr
+
+	.globl mmu_disable
+mmu_disable:		@ void mmu_disable(); write back and disable caches and MMU
+	mov	r1, #0		@ zero
+	mcr	p15, 0, r1, c7, c14, 0 @ clean and invalidate D-cache
+	mcr	p15, 0, r1, c7, c10, 4 @ data synchronization barrier
+	mrc	p15, 0, r2, c1, c0, 0 @ read control register
+	ldr	r3, =0x00001805	@ I | Z | C | M
+	bic	r2, r2, r3	@ caches, prediction and MMU off
+	mcr	p15, 0, r2, c1, c0, 0 @ write control register
+	mcr	p15, 0, r1, c7, c5, 0 @ invalidate I-cache
+	mcr	p15, 0, r1, c7, c5, 6 @ flush BTAC
+	mcr	p15, 0, r1, c8, c7, 0 @ invalidate TLBs
+	mcr	p15, 0, r1, c7, c5, 4 @ flush prefetch buffer
+	bx	lr
+
+	.globl dcache_clean_range
+dcache_clean_range:	@ void dcache_clean_range(u32 addr, u32 len); before DMA out
+	add	r1, r0, r1	@ end address
+	bic	r0, r0, #0x1F	@ align to cache-line
+1:	mcr	p15, 0, r0, c7, c10, 1 @ clean D-cache line
+	add	r0, r0, #32	@ next cache-line
+	cmp	r0, r1		@ until end
+	blo	1b
+	mov	r0, #0		@ zero
+	mcr	p15, 0, r0, c7, c10, 4 @ data synchronization barrier
+	bx	lr
+
+	.globl dcache_invalidate_range
+dcache_invalidate_range: @ void dcache_invalidate_range(u32 addr, u32 len); after DMA in
+	add	r1, r0, r1	@ end address
+	bic	r0, r0, #0x1F	@ align to cache-line
+1:	mcr	p15, 0, r0, c7, c6, 1 @ invalidate D-cache line
+	add	r0, r0, #32	@ next cache-line
+	cmp	r0, r1		@ until end
+	blo	1b
+	bx	lr
+
+	.globl icache_sync_range
+icache_sync_range:	@ void icache_sync_range(u32 addr, u32 len); after writing code
+	add	r1, r0, r1	@ end address
+	bic	r0, r0, #0x1F	@ align to cache-line
+	mov	r2, r0		@ remember start
+1:	mcr	p15, 0, r0, c7, c10, 1 @ clean D-cache line
+	add	r0, r0, #32	@ next cache-line
+	cmp	r0, r1		@ until end
+	blo	1b
+	mov	r3, #0		@ zero
+	mcr	p15, 0, r3, c7, c10, 4 @ data synchronization barrier
+2:	mcr	p15, 0, r2, c7, c5, 1 @ invalidate I-cache line
+	add	r2, r2, #32	@ next cache-line
+	cmp	r2, r1		@ until end
+	blo	2b
+	mcr	p15, 0, r3, c7, c5, 6 @ flush BTAC
+	mcr	p15, 0, r3, c7, c5, 4 @ flush prefetch buffer
+	bx	lr
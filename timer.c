@@ -34,7 +34,7 @@ struct timer {
     u32         _28;
     u32         _2c;
 };
-#define TIMER           ((volatile struct timer *)0x2000b400)
+#define TIMER           ((volatile struct timer *)(PERIPH_BASE + 0xB400))
 
 /*
  * Initialize 1Mhz timer
@@ -119,3 +119,236 @@ timer_stop()
     t0 = t1;
     return dt;
 }
+
+/*
+ * Timer-wheel service
+ *
+ * Pending timers are kept in a hierarchical wheel of WHEEL_LEVELS rings
+ * with WHEEL_SLOTS slots each.  The system-timer compare 1 interrupt
+ * advances a tick counter every TICK_USECS.  Expired timers are
+ * delivered as messages on the dispatch path (see irq_events).
+ *
+ * Timer blocks are released only by timer_cancel, never by the wheel.
+ * A one-shot that fires is marked with a null target and kept until it
+ * is cancelled, so a handle held past expiration never refers to a block
+ * that has been reused.
+ */
+#define SYSTIMER_CS     (PERIPH_BASE + 0x3000)    // control/status (match flags)
+#define SYSTIMER_CLO    (PERIPH_BASE + 0x3004)    // counter, low 32 bits (1MHz)
+#define SYSTIMER_C1     (PERIPH_BASE + 0x3010)    // compare 1 (free for ARM use)
+
+#define TICK_SHIFT      (10)            // 1024us per tick
+#define TICK_USECS      (1 << TICK_SHIFT)
+#define WHEEL_BITS      (6)
+#define WHEEL_SLOTS     (1 << WHEEL_BITS)
+#define WHEEL_MASK      (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS    (4)             // 2^24 ticks (~4.8 hours) range
+
+struct wheel_link {
+    struct wheel_link*  next;
+    struct wheel_link*  prev;
+};
+
+struct wheel_timer {  // 32-byte kernel block
+    struct wheel_link   link;           // _00, _04
+    u32                 expires;        // _08: tick of expiration
+    u32                 period;         // _0c: ticks between repeats, or 0
+    ACTOR*              target;         // _10: actor to notify
+    u32                 msg;            // _14: message data
+    u32                 _18;
+    u32                 _1c;
+};
+
+static struct wheel_link wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+static u32 wheel_now = 0;  // last tick processed
+static u32 wheel_pending = 0;  // timers in the wheel
+static volatile u32 wheel_ticks = 0;  // ticks counted by interrupt
+volatile u32 timer_due = 0;  // != 0 if ticks need processing
+
+extern void send_2(ACTOR* target, u32 msg_1, u32 msg_2);
+
+static void
+wheel_insert(struct wheel_timer* t)
+{
+    struct wheel_link* head;
+    u32 delta = t->expires - wheel_now;
+    u32 e = t->expires;
+    int n = 0;
+
+    if ((int)delta < 0) {  // overdue
+        e = wheel_now;
+        delta = 0;
+    } else if (delta >= (1 << (WHEEL_BITS * WHEEL_LEVELS))) {  // clamp to range
+        e = wheel_now + (1 << (WHEEL_BITS * WHEEL_LEVELS)) - 1;
+        delta = e - wheel_now;
+    }
+    while (delta >= WHEEL_SLOTS) {
+        delta >>= WHEEL_BITS;
+        ++n;
+    }
+    head = &wheel[n][(e >> (WHEEL_BITS * n)) & WHEEL_MASK];
+    if (!head->next) {  // lazy initialization of empty slot
+        head->next = head->prev = head;
+    }
+    t->link.next = head;
+    t->link.prev = head->prev;
+    head->prev->next = &t->link;
+    head->prev = &t->link;
+}
+
+static void
+wheel_remove(struct wheel_timer* t)
+{
+    t->link.prev->next = t->link.next;
+    t->link.next->prev = t->link.prev;
+    t->link.next = t->link.prev = NULL;
+}
+
+/*
+ * Re-distribute the timers in a higher-level slot
+ */
+static void
+wheel_cascade(int n, int i)
+{
+    struct wheel_link* head = &wheel[n][i];
+    struct wheel_timer* t;
+
+    while (head->next && (head->next != head)) {
+        t = (struct wheel_timer*)head->next;
+        wheel_remove(t);
+        wheel_insert(t);
+    }
+}
+
+/*
+ * Advance the wheel by one tick, delivering expired timers
+ */
+static void
+wheel_advance()
+{
+    struct wheel_link* head;
+    struct wheel_timer* t;
+    u32 now = ++wheel_now;
+    int n;
+
+    for (n = 1; n < WHEEL_LEVELS; ++n) {
+        if (now & ((1 << (WHEEL_BITS * n)) - 1)) {
+            break;  // no carry into level n
+        }
+        wheel_cascade(n, (now >> (WHEEL_BITS * n)) & WHEEL_MASK);
+    }
+    head = &wheel[0][now & WHEEL_MASK];
+    while (head->next && (head->next != head)) {
+        t = (struct wheel_timer*)head->next;
+        wheel_remove(t);
+        send_2(t->target, t->msg, (u32)t);  // message = (msg, timer)
+        if (t->period) {
+            t->expires += t->period;
+            wheel_insert(t);
+        } else {
+            --wheel_pending;
+            t->target = NULL;  // fired, kept until timer_cancel
+        }
+    }
+}
+
+/*
+ * Service system-timer compare interrupt (called from irq_handler)
+ */
+void
+timer_irq()
+{
+    u32 next = GET_32(SYSTIMER_C1) + TICK_USECS;
+
+    PUT_32(SYSTIMER_CS, 1 << IRQ_SYSTIMER_1);  // clear match flag
+    if ((int)(next - GET_32(SYSTIMER_CLO)) <= 0) {  // fell behind
+        next = GET_32(SYSTIMER_CLO) + TICK_USECS;
+    }
+    PUT_32(SYSTIMER_C1, next);
+    ++wheel_ticks;
+    timer_due = 1;
+    irq_due = 1;  // deliver on the dispatch path
+}
+
+/*
+ * Deliver expired timers (called on the dispatch path when timer_due)
+ */
+void
+timer_expire()
+{
+    timer_due = 0;
+    while (wheel_now != wheel_ticks) {
+        wheel_advance();
+    }
+    if (wheel_pending == 0) {  // stop ticking when idle
+        PUT_32(IRQ_DISABLE_1, 1 << IRQ_SYSTIMER_1);
+    }
+}
+
+static struct wheel_timer*
+timer_schedule(u32 dt, u32 period, ACTOR* target, u32 msg)
+{
+    struct wheel_timer* t;
+    u32 ticks = (dt + TICK_USECS - 1) >> TICK_SHIFT;
+
+    t = reserve();
+    t->expires = wheel_now + (ticks ? ticks : 1);
+    t->period = period;
+    t->target = target;
+    t->msg = msg;
+    wheel_insert(t);
+    if (wheel_pending++ == 0) {  // start ticking
+        wheel_ticks = wheel_now;
+        PUT_32(SYSTIMER_C1, GET_32(SYSTIMER_CLO) + TICK_USECS);
+        PUT_32(SYSTIMER_CS, 1 << IRQ_SYSTIMER_1);
+        PUT_32(IRQ_ENABLE_1, 1 << IRQ_SYSTIMER_1);
+    }
+    return t;
+}
+
+/*
+ * Send (msg, timer) to target after dt microseconds, once
+ */
+void*
+timer_after(u32 dt, ACTOR* target, u32 msg)
+{
+    return timer_schedule(dt, 0, target, msg);
+}
+
+/*
+ * Send (msg, timer) to target every dt microseconds, until cancelled
+ */
+void*
+timer_every(u32 dt, ACTOR* target, u32 msg)
+{
+    u32 ticks = (dt + TICK_USECS - 1) >> TICK_SHIFT;
+
+    return timer_schedule(dt, (ticks ? ticks : 1), target, msg);
+}
+
+/*
+ * Cancel and release a timer (also required for a one-shot that has fired)
+ */
+void
+timer_cancel(void* timer)
+{
+    struct wheel_timer* t = timer;
+
+    if (!t) {
+        return;
+    }
+    if (t->target) {  // still in the wheel
+        wheel_remove(t);
+        --wheel_pending;
+    }
+    release(t);
+}
+
+/*
+ * Number of timers pending in the wheel
+ */
+u32
+timer_pending()
+{
+    return wheel_pending;
+}
@@ -33,4 +33,12 @@ extern int      timer_split();                  /* time since start */
 extern int      timer_lap();                    /* time since last lap or start */
 extern int      timer_stop();                   /* total time, start reset */
 
+extern void*    timer_after(u32 dt, ACTOR* target, u32 msg);  /* send (msg, timer) after dt */
+extern void*    timer_every(u32 dt, ACTOR* target, u32 msg);  /* send (msg, timer) every dt */
+extern void     timer_cancel(void* timer);      /* cancel and release timer */
+extern u32      timer_pending();                /* number of pending timers */
+extern void     timer_irq();                    /* service compare interrupt */
+extern void     timer_expire();                 /* deliver expired timers */
+extern volatile u32 timer_due;                  /* != 0 if ticks need processing */
+
 #endif /* _TIMER_H_ */
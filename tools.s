@@ -526,14 +526,31 @@ a_kernel_read:		@ kernel read actor
 	bl	serial_eol	@ write end-of-line
 	ldr	r0, =prompt_txt	@ load address of prompt
 	bl	serial_puts	@ write text to console
-	bl	parse_sexpr	@ parse s-expression from input
+	ldr	r0, =a_kernel_wait @ target actor
+	ldmib	fp, {r1,r2}	@ get (ok, fail)
+	bl	send_2		@ wait for input
+	b	complete	@ return to dispatch loop
+prompt_txt:
+	.ascii	"> \0"
+
+	.text
+	.align 5		@ align to cache-line
+	.global a_kernel_wait
+a_kernel_wait:		@ kernel input wait actor
+			@ message = (ok, fail)
+	bl	char_ready	@ input available?
+	teq	r0, #0		@ if ready
+	bne	1f		@	parse input
+	ldr	r0, =a_kernel_wait @ target actor (self)
+	ldmib	fp, {r1,r2}	@ get (ok, fail)
+	bl	serial_rx_wait	@ try again when input arrives
+	b	complete	@ return to dispatch loop
+1:	bl	parse_sexpr	@ parse s-expression from input
 	movs	r1, r0		@ if expr == NULL
 	ldreq	r0, [fp, #0x08]	@	send to fail
 	ldrne	r0, [fp, #0x04]	@ else
 	bl	send_1		@	send expr to ok
 	b	complete	@ return to dispatch loop
-prompt_txt:
-	.ascii	"> \0"
 
 	.text
 	.align 5		@ align to cache-line
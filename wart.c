@@ -24,9 +24,9 @@ See further [https://github.com/organix/mycelia/blob/master/wart.md]
 #define PTRACE(x)       // include/exclude PEG-actor tracing
 
 #define NO_CELL_FREE  0 // never release allocated cells
-#define GC_CALL_DEPTH 0 // count recursion depth during garbage collection
 #define GC_TRACE_FREE 1 // trace free list during mark phase
 #define CONCURRENT_GC 0 // interleave garbage collection with event dispatch
+#define INCREMENT_GC  1 // perform bounded gc steps after each event dispatch
 #define MULTIPHASE_GC 0 // perform gc mark and sweep separately
 #define TIME_DISPATCH 1 // measure execution time for message dispatch
 #define META_ACTORS   1 // include meta-actors facilities
@@ -155,21 +155,39 @@ int_t failure(char *_file_, int _line_) {
 
 #define ASSERT(cond)    if (!(cond)) return failure(__FILE__, __LINE__)
 
+#if CONCURRENT_GC && INCREMENT_GC
+#error "choose either CONCURRENT_GC or INCREMENT_GC"
+#endif
+
 /*
  * heap memory management (cells)
  */
 
-#define CELL_MAX (1 << 12)  // 4K cells
-cell_t cell[CELL_MAX] = {
-    { .head = 1, .tail = 1 },  // root cell (limit,free)
-    { .head = 0, .tail = 0 },  // end of free-list
-};
+#define CELL_SEGMENT (1 << 12)  // 4K cells per heap segment
+#define CELL_LIMIT (1 << 16)  // default heap size limit (see `-m` option)
+cell_t *cell = PTR(0);  // see heap_init()
+nat_t cell_max = 0;     // cells in committed heap segments
+nat_t cell_limit = 0;   // cells reserved for heap growth
 // note: free-list is linked by index, not with pointers
 
 int in_heap(int_t val) {
-    return IS_ADDR(val) && (NAT(TO_PTR(val) - PTR(cell)) < sizeof(cell));
+    return IS_ADDR(val) && (NAT(TO_PTR(val) - PTR(cell)) < (cell_max * sizeof(cell_t)));
+}
+
+static int cell_grow() {  // commit another heap segment, if any remain
+    if (cell_max >= cell_limit) return 0;
+    cell_max += CELL_SEGMENT;
+    if (cell_max > cell_limit) {
+        cell_max = cell_limit;
+    }
+    DEBUG(fprintf(stderr, "cell_grow: max=%"PRIuPTR" limit=%"PRIuPTR"\n", cell_max, cell_limit));
+    return 1;
 }
 
+i64 cell_alloc_cnt = 0;         // total cells allocated
+i64 gc_ticks = 0;               // clock ticks spent collecting garbage
+i32 gc_cycle_count = 0;         // number of gc cycles started
+
 PROC_DECL(FreeCell) {
     ERROR(debug_print("FreeCell self", self));
     return panic("DISPATCH TO FREE CELL!");
@@ -185,29 +203,49 @@ static void gc_clr_mark(i32 ofs);  // FORWARD DECLARATION
 static int gc_free_cnt = 0;
 #endif
 
+#if INCREMENT_GC
+#define GC_IDLE     (0)     // no collection in progress
+#define GC_MARK     (1)     // tracing from the root-set
+#define GC_SWEEP    (2)     // reclaiming unmarked cells
+static int gc_phase = GC_IDLE;
+static void gc_set_mark(i32 ofs);  // FORWARD DECLARATION
+static i32 gc_shade(int_t val);  // FORWARD DECLARATION
+// write barrier: a value stored while marking must not be left unmarked
+#define GC_BARRIER(val)  if (gc_phase == GC_MARK) gc_shade(val)
+#else
+#define GC_BARRIER(val)
+#endif
+
+static void cell_alloc(int_t ofs) {  // account for a newly allocated cell
+    ++cell_alloc_cnt;
+#if CONCURRENT_GC
+    gc_set_mark(ofs);
+#endif
+#if INCREMENT_GC
+    if (gc_phase != GC_IDLE) gc_set_mark(ofs);  // allocate black
+#endif
+}
+
 static cell_t *cell_new() {
     int_t head = cell[0].tail;
     int_t next = cell[head].tail;
     if (next) {
         // use cell from free-list
         cell[0].tail = next;
-#if CONCURRENT_GC
-        gc_set_mark(head);
-#else
+#if !CONCURRENT_GC
         --gc_free_cnt;
 #endif
+        cell_alloc(head);
         return &cell[head];
     }
     next = head + 1;
-    if (next < CELL_MAX) {
+    if ((next < cell_max) || cell_grow()) {
         // extend top of heap
         cell[next].head = 0;
         cell[next].tail = 0;
         cell[0].head = next;
         cell[0].tail = next;
-#if CONCURRENT_GC
-        gc_set_mark(head);
-#endif
+        cell_alloc(head);
         return &cell[head];
     }
     panic("out of cell memory");
@@ -218,6 +256,7 @@ static void cell_reclaim(cell_t *p) {
     XDEBUG(fprintf(stderr, "cell_reclaim: p=%p\n", p));
 #if !NO_CELL_FREE
     // link into free-list
+    p->head = FREE_CELL;  // note: incremental sweep skips free cells
     p->tail = cell[0].tail;
     int_t ofs = INT(p - cell);
     XDEBUG(fprintf(stderr, "cell_reclaim: ofs=%"PRIdPTR"\n", ofs));
@@ -248,19 +287,68 @@ int_t cell_free(int_t val) {
 }
 
 int_t cons(int_t head, int_t tail) {
+    GC_BARRIER(head);
+    GC_BARRIER(tail);
     cell_t *p = cell_new();
     p->head = head;
     p->tail = tail;
     return MK_PAIR(p);
 }
 
+int_t cell_list(int_t *v, int n, int_t tail) {  // allocate `n` list cells at once
+    int_t top = cell[0].head;
+    if ((cell[0].tail == top) && (NAT(top + n) < cell_max)) {
+        // free-list is empty, take contiguous cells from top of heap
+        for (int i = 0; i < n; ++i) {
+            GC_BARRIER(v[i]);
+        }
+        GC_BARRIER(tail);
+        cell_t *p = &cell[top];
+        cell[top + n].head = 0;
+        cell[top + n].tail = 0;
+        cell[0].head = top + n;
+        cell[0].tail = top + n;
+        for (int i = 0; i < n; ++i) {
+            cell_alloc(top + i);
+            p[i].head = v[i];
+            p[i].tail = MK_PAIR(&p[i + 1]);
+        }
+        p[n - 1].tail = tail;
+        return MK_PAIR(p);
+    }
+    while (n > 0) {
+        tail = cons(v[--n], tail);  // allocate from free-list
+    }
+    return tail;
+}
+
 #define list_0  NIL
 #define list_1(v1)  cons((v1), NIL)
-#define list_2(v1,v2)  cons((v1), cons((v2), NIL))
-#define list_3(v1,v2,v3)  cons((v1), cons((v2), cons((v3), NIL)))
-#define list_4(v1,v2,v3,v4)  cons((v1), cons((v2), cons((v3), cons((v4), NIL))))
-#define list_5(v1,v2,v3,v4,v5)  cons((v1), cons((v2), cons((v3), cons((v4), cons((v5), NIL)))))
-#define list_6(v1,v2,v3,v4,v5,v6)  cons((v1), cons((v2), cons((v3), cons((v4), cons((v5), cons((v6), NIL))))))
+
+int_t list_2(int_t v1, int_t v2) {
+    int_t v[] = { v1, v2 };
+    return cell_list(v, 2, NIL);
+}
+
+int_t list_3(int_t v1, int_t v2, int_t v3) {
+    int_t v[] = { v1, v2, v3 };
+    return cell_list(v, 3, NIL);
+}
+
+int_t list_4(int_t v1, int_t v2, int_t v3, int_t v4) {
+    int_t v[] = { v1, v2, v3, v4 };
+    return cell_list(v, 4, NIL);
+}
+
+int_t list_5(int_t v1, int_t v2, int_t v3, int_t v4, int_t v5) {
+    int_t v[] = { v1, v2, v3, v4, v5 };
+    return cell_list(v, 5, NIL);
+}
+
+int_t list_6(int_t v1, int_t v2, int_t v3, int_t v4, int_t v5, int_t v6) {
+    int_t v[] = { v1, v2, v3, v4, v5, v6 };
+    return cell_list(v, 6, NIL);
+}
 
 int_t car(int_t val) {
     if (!IS_PAIR(val)) return error("car() of non-PAIR");
@@ -304,12 +392,14 @@ int list_len(int_t val) {
 int_t set_car(int_t val, int_t head) {
     if (!in_heap(val)) panic("set_car() of non-heap cell");
     cell_t *p = TO_PTR(val);
+    GC_BARRIER(head);
     return p->head = head;
 }
 
 int_t set_cdr(int_t val, int_t tail) {
     if (!in_heap(val)) panic("set_cdr() of non-heap cell");
     cell_t *p = TO_PTR(val);
+    GC_BARRIER(tail);
     return p->tail = tail;
 }
 
@@ -355,13 +445,14 @@ PROC_DECL(obj_call) {
 #define GC_LO_BITS(ofs) ((ofs) & 0x1F)
 #define GC_HI_BITS(ofs) ((ofs) >> 5)
 
-#define GC_MAX_BITS GC_HI_BITS(CELL_MAX)
+#define GC_MAX_BITS(max) GC_HI_BITS((max) + 0x1F)
 
-i32 gc_bits[GC_MAX_BITS];
+i32 *gc_bits = PTR(0);  // see heap_init()
 
 i32 gc_clear() {  // clear all GC bits
     XDEBUG(fprintf(stderr, "> gc_clear\n"));
-    for (i32 i = 0; i < GC_MAX_BITS; ++i) {
+    i32 n = GC_MAX_BITS(cell_max);
+    for (i32 i = 0; i < n; ++i) {
         gc_bits[i] = 0;
     }
     XDEBUG(fprintf(stderr, "< gc_clear\n"));
@@ -403,51 +494,56 @@ i32 gc_mark_free() {  // mark cells in the free-list
     return cnt;
 }
 
-#if GC_CALL_DEPTH
-i32 gc_mark_cell(int_t val, i32 depth)
-#else
-i32 gc_mark_cell(int_t val)
-#endif
-{  // mark cells reachable from `val`
-    //DEBUG(fprintf(stderr, "> gc_mark_cell val=16#%"PRIxPTR"\n", val));
-    XDEBUG(debug_print("> gc_mark_cell", val));
+/*
+ * marking uses an explicit stack of heap offsets (grey cells), rather than
+ * recursion, so deep structures can't overflow the C stack. a cell is
+ * marked when it is pushed, so it is pushed at most once per gc cycle.
+ */
+static i32 *gc_stack = PTR(0);  // see heap_init()
+static i32 gc_stack_top = 0;
+
+static i32 gc_shade(int_t val) {  // mark `val` and queue it for scanning
+    if (!in_heap(val)) return 0;
+    cell_t *p = TO_PTR(val);
+    i32 ofs = INT(p - cell);
+    if (gc_get_mark(ofs)) return 0;  // cell already marked
+    gc_set_mark(ofs);
+    gc_stack[gc_stack_top++] = ofs;
+    return 1;
+}
+
+static i32 gc_scan(i32 limit) {  // scan at most `limit` grey cells
     i32 cnt = 0;
-    while (in_heap(val)) {
-        cell_t *p = TO_PTR(val);
-        i32 ofs = INT(p - cell);
-        if (gc_get_mark(ofs)) {
-            break;  // cell already marked
-        }
-        gc_set_mark(ofs);
+    while ((cnt < limit) && (gc_stack_top > 0)) {
+        cell_t *p = &cell[gc_stack[--gc_stack_top]];
+        gc_shade(p->head);
+        gc_shade(p->tail);
         ++cnt;
-#if GC_CALL_DEPTH
-        cnt += gc_mark_cell(p->head, ++depth);  // recurse on head
-#else
-        cnt += gc_mark_cell(p->head);  // recurse on head
-#endif
-        val = p->tail;  // iterate over tail
     }
-#if GC_CALL_DEPTH
-    XDEBUG(fprintf(stderr, "< gc_mark_cell depth=%d (cnt=%d)\n", depth, cnt));
-#else
+    return cnt;
+}
+
+i32 gc_mark_cell(int_t val) {  // mark cells reachable from `val`
+    XDEBUG(debug_print("> gc_mark_cell", val));
+    gc_shade(val);
+    i32 cnt = gc_scan(INT(cell_max));
     XDEBUG(fprintf(stderr, "< gc_mark_cell (cnt=%d)\n", cnt));
-#endif
-    //XDEBUG(fprintf(stderr, "< gc_mark_cell val=16#%"PRIxPTR" (cnt=%d)\n", val, cnt));
     return cnt;
 }
 
-static cell_t event_q;  // FORWARD DECLARATION
-static cell_t gnd_locals;  // FORWARD DECLARATION
-i32 gc_mark_roots() {  // mark cells reachable from the root-set
-    XDEBUG(fprintf(stderr, "> gc_mark_roots\n"));
-    i32 n = 0;
-#if GC_CALL_DEPTH
-    n += gc_mark_cell(event_q.head, 0);
-    n += gc_mark_cell(gnd_locals.head, 0);
+i32 event_q_shade();  // FORWARD DECLARATION
+#if PEG_ACTORS
+void peg_memo_clear();  // FORWARD DECLARATION
+#define GC_EVICT()  peg_memo_clear()  // drop caches that are not gc roots
 #else
-    n += gc_mark_cell(event_q.head);
-    n += gc_mark_cell(gnd_locals.head);
+#define GC_EVICT()
 #endif
+i32 global_shade();  // FORWARD DECLARATION
+i32 gc_mark_roots() {  // mark cells reachable from the root-set
+    XDEBUG(fprintf(stderr, "> gc_mark_roots\n"));
+    event_q_shade();
+    global_shade();
+    i32 n = gc_scan(INT(cell_max));
     XDEBUG(fprintf(stderr, "< gc_mark_roots (n=%d)\n", n));
     return n;
 }
@@ -470,20 +566,123 @@ i32 gc_sweep() {  // free unmarked cells
 }
 
 i32 gc_mark_and_sweep() {
+    clock_t t0 = clock();
+#if INCREMENT_GC
+    gc_phase = GC_IDLE;  // abandon any incremental cycle in progress
+    gc_stack_top = 0;
+#endif
+    ++gc_cycle_count;
     i32 n = gc_clear();
     n = gc_mark_free();
     XDEBUG(printf("gc_mark_and_sweep: marked %d free cells\n", n));
     n = gc_mark_roots();
     XDEBUG(printf("gc_mark_and_sweep: marked %d used cells\n", n));
+    GC_EVICT();
     n = gc_sweep();
     XDEBUG(printf("gc_mark_and_sweep: free'd %d dead cells\n", n));
+    gc_ticks += (clock() - t0);
     return n;
 }
 
+#if INCREMENT_GC
+/*
+ * incremental tri-color collection, one bounded step after each event.
+ * white cells are unmarked, grey cells are marked and on `gc_stack`,
+ * black cells are marked and scanned. cells allocated during a cycle
+ * start out black, and GC_BARRIER() shades every value stored while
+ * marking, so a black cell never refers to a white one. the root-set
+ * is written directly (not through the barrier), so it is re-scanned
+ * before marking is declared complete.
+ */
+#define GC_MARK_STEP    (128)   // grey cells scanned per event
+#define GC_SWEEP_STEP   (512)   // heap cells swept per event
+#define GC_START_FREE   INT(cell_max / 4)   // begin a cycle below this headroom
+#define GC_FORCE_FREE   INT(cell_max / 32)  // finish a cycle below this headroom
+
+static i32 gc_sweep_next = 0;   // next heap offset to sweep (descending)
+
+static i32 gc_headroom() {  // cells available without collection
+    return gc_free_cnt + (INT(cell_max) - INT(cell[0].head));
+}
+
+static i32 gc_sweep_step(i32 limit) {  // sweep at most `limit` cells
+    i32 cnt = 0;
+    while ((cnt < limit) && (--gc_sweep_next > 0)) {
+        cell_t *p = &cell[gc_sweep_next];
+        if (!gc_get_mark(gc_sweep_next) && (p->head != FREE_CELL)) {
+            cell_reclaim(p);
+        }
+        ++cnt;
+    }
+    if (gc_sweep_next <= 0) {
+        gc_phase = GC_IDLE;  // cycle complete
+        if (gc_headroom() < GC_START_FREE) {
+            cell_grow();  // avoid starting the next cycle immediately
+        }
+    }
+    return cnt;
+}
+
+i32 gc_increment() {  // perform one bounded step, return cells visited
+    i32 n = 0;
+    if (gc_phase == GC_IDLE) {
+        if (gc_headroom() >= GC_START_FREE) return 0;
+        XDEBUG(fprintf(stderr, "gc_increment: start (headroom=%d)\n", gc_headroom()));
+        ++gc_cycle_count;
+        gc_clear();
+        event_q_shade();  // later additions pass through GC_BARRIER()
+        global_shade();
+        gc_phase = GC_MARK;
+    }
+    if (gc_phase == GC_MARK) {
+        n = gc_scan(GC_MARK_STEP);
+        if (gc_stack_top == 0) {
+            XDEBUG(fprintf(stderr, "gc_increment: sweep\n"));
+            GC_EVICT();
+            gc_sweep_next = INT(cell[0].head);
+            gc_phase = GC_SWEEP;
+        }
+    } else if (gc_phase == GC_SWEEP) {
+        n = gc_sweep_step(GC_SWEEP_STEP);
+    }
+    return n;
+}
+
+i32 gc_collect() {  // gc step, or finish the cycle if memory is tight
+    i32 n = gc_increment();
+    if (gc_headroom() < GC_FORCE_FREE) {
+        DEBUG(fprintf(stderr, "gc_collect: forced (headroom=%d)\n", gc_headroom()));
+        while (gc_phase != GC_IDLE) {
+            n += gc_increment();
+        }
+    }
+    return n;
+}
+#endif // INCREMENT_GC
+
+int_t heap_init(nat_t limit) {  // reserve `limit` cells, commit one segment
+    if (limit < CELL_SEGMENT) {
+        limit = CELL_SEGMENT;
+    }
+    cell = calloc(limit, sizeof(cell_t));
+    gc_bits = calloc(GC_MAX_BITS(limit), sizeof(i32));
+    gc_stack = calloc(limit, sizeof(i32));
+    if (!cell || !gc_bits || !gc_stack) return panic("heap reservation failed");
+    cell_limit = limit;
+    cell_max = CELL_SEGMENT;
+    cell[0].head = 1;  // root cell (limit,free)
+    cell[0].tail = 1;
+    cell[1].head = 0;  // end of free-list
+    cell[1].tail = 0;
+    return OK;
+}
+
 int_t cell_usage() {
+    static i64 prev_alloc = 0;
+    static clock_t prev_time = 0;
     WARN(fprintf(stderr,
-        "> cell_usage: limit=%"PRIdPTR" free=%"PRIdPTR" max=%"PRIdPTR"\n",
-        cell[0].head, cell[0].tail, INT(CELL_MAX)));
+        "> cell_usage: limit=%"PRIdPTR" free=%"PRIdPTR" max=%"PRIuPTR"/%"PRIuPTR"\n",
+        cell[0].head, cell[0].tail, cell_max, cell_limit));
 #if !CONCURRENT_GC
     WARN(fprintf(stderr, "  cell_usage: gc_free_cnt %d\n", gc_free_cnt));
 #endif
@@ -496,9 +695,17 @@ int_t cell_usage() {
         prev = next;
         next = cell[prev].tail;
     }
+    clock_t now = clock();
+    double dt = (double)(now - prev_time) / CLOCKS_PER_SEC;
+    double rate = (dt > 0) ? ((double)(cell_alloc_cnt - prev_alloc) / dt) : 0;
+    WARN(fprintf(stderr,
+        "  cell_usage: alloc=%"PRId64" rate=%.0f/s gc=%.6fs cycles=%d\n",
+        cell_alloc_cnt, rate, (double)gc_ticks / CLOCKS_PER_SEC, gc_cycle_count));
+    prev_alloc = cell_alloc_cnt;
+    prev_time = now;
     WARN(fprintf(stderr,
-        "< cell_usage: free=%"PRIdPTR" total=%"PRIdPTR" max=%"PRIdPTR"\n",
-        count, next-1, INT(CELL_MAX)));
+        "< cell_usage: free=%"PRIdPTR" total=%"PRIdPTR" max=%"PRIuPTR"\n",
+        count, next-1, cell_max));
     return cons(MK_NUM(count), MK_NUM(next-1));  // cells (free, heap)
 }
 
@@ -515,31 +722,48 @@ int is_symbol(int_t val) {
     return IS_SYM(val) && (NAT(PTR(&intern[TO_ENUM(val)]) - PTR(intern)) < sizeof(intern));
 }
 
+#define INTERN_HASH (1 << 11)  // must be a power of 2, > INTERN_MAX/2
+static i32 intern_hash[INTERN_HASH];  // (offset + 1) into `intern`, or 0 if empty
+static int_t intern_top = 0;  // end of interned strings
+
+static nat_t intern_hash_str(char *s, int_t n) {  // FNV-1a string hash
+    nat_t h = 2166136261u;
+    while (n-- > 0) {
+        h = (h ^ (unsigned char)*s++) * 16777619u;
+    }
+    return h;
+}
+
 int_t symbol(char *s) {
     int_t j;
     int_t n = 0;
     while (s[n]) ++n;  // compute c-string length
-    int_t i = 0;
-    while (intern[i]) {
-        int_t m = intern[i++];  // symbol length
-        if (n == m) {
+    nat_t h = intern_hash_str(s, n);
+    for (;;) {  // open addressing, linear probe
+        i32 k = intern_hash[h & (INTERN_HASH - 1)];
+        if (k == 0) break;  // empty slot
+        int_t i = k;  // skip symbol length
+        if (n == intern[k - 1]) {
             for (j = 0; (j < n); ++j) {
                 if (s[j] != intern[i+j]) {
                     goto next;
                 }
             }
             // found it!
-            return MK_SYM(i-1);
+            return MK_SYM(k - 1);
         }
-next:   i += m;
+next:   ++h;
     }
     // new symbol
+    int_t i = intern_top;
     if ((i + n + 1) >= INTERN_MAX) return panic("out of symbol memory");
+    intern_hash[h & (INTERN_HASH - 1)] = i + 1;
     intern[i++] = n;
     for (j = 0; (j < n); ++j) {
         intern[i+j] = s[j];
     }
     intern[i+n] = 0;
+    intern_top = i + n;
     return MK_SYM(i-1);
 }
 
@@ -581,6 +805,7 @@ int_t s_list_to_symbol;
 int_t s_print;
 int_t s_emit;
 int_t s_debug_print;
+int_t s_bench;
 int_t s_fold;
 int_t s_foldr;
 int_t s_bind;
@@ -635,6 +860,7 @@ int_t symbol_boot() {
     s_print = symbol("print");
     s_emit = symbol("emit");
     s_debug_print = symbol("debug-print");
+    s_bench = symbol("bench");
     s_fold = symbol("fold");
     s_foldr = symbol("foldr");
     s_bind = symbol("bind");
@@ -655,41 +881,89 @@ int_t symbol_boot() {
  * actor event dispatch
  */
 
-static cell_t event_q = { .head = NIL, .tail = NIL };
+/*
+ * queued events are kept in a ring of event pairs `(target . msg)`, so
+ * there is no per-event link cell. events sent during dispatch are held
+ * in a pending-effects buffer, and only reach the ring on commit.
+ */
+#define EVENT_Q_MIN (1 << 8)  // initial capacity (must be a power of 2)
+
+typedef struct event_buf {
+    int_t      *event;          // event pairs
+    nat_t       size;           // capacity (power of 2 for the ring)
+    nat_t       head;           // index of oldest event (ring only)
+    nat_t       tail;           // index of next free slot
+} event_buf_t;
+
+static event_buf_t event_q = { .event = PTR(0) };   // event ring
+static event_buf_t event_fx = { .event = PTR(0) };  // pending SENDs
+static int event_txn = 0;  // set while effects are pending
+
+static void event_buf_grow(event_buf_t *q) {  // double buffer capacity
+    nat_t size = (q->size ? (q->size << 1) : EVENT_Q_MIN);
+    int_t *event = malloc(size * sizeof(int_t));
+    if (!event) {
+        panic("out of event memory");
+    }
+    nat_t n = q->tail - q->head;
+    for (nat_t i = 0; i < n; ++i) {  // unwrap ring into new buffer
+        event[i] = q->event[(q->head + i) & (q->size - 1)];
+    }
+    free(q->event);
+    q->event = event;
+    q->size = size;
+    q->head = 0;
+    q->tail = n;
+}
+
+nat_t event_q_len() {
+    return event_q.tail - event_q.head;
+}
 
 int_t event_q_put(int_t event) {
     if (!IS_PAIR(event)) return FAIL;
-    int_t tail = cons(event, NIL);
-    if (event_q.head == NIL) {
-        event_q.head = tail;
-    } else {
-        set_cdr(event_q.tail, tail);
+    if (event_q_len() >= event_q.size) {
+        event_buf_grow(&event_q);
     }
-    event_q.tail = tail;
+    GC_BARRIER(event);  // the ring is part of the gc root-set
+    event_q.event[event_q.tail++ & (event_q.size - 1)] = event;
     return OK;
 }
 
 int_t event_q_pop() {
-    if (event_q.head == NIL) return UNDEF; // event queue empty
-    int_t head = event_q.head;
-    event_q.head = cdr(head);
-    if (event_q.head == NIL) {
-        event_q.tail = NIL;  // empty queue
-    }
-    int_t event = car(head);
-    head = cell_free(head);
-    return event;
+    if (event_q.head == event_q.tail) return UNDEF; // event queue empty
+    return event_q.event[event_q.head++ & (event_q.size - 1)];
+}
+
+i32 event_q_shade() {  // shade queued and pending events (gc roots)
+    i32 n = 0;
+    for (nat_t i = event_q.head; i != event_q.tail; ++i) {
+        n += gc_shade(event_q.event[i & (event_q.size - 1)]);
+    }
+    for (nat_t i = 0; i < event_fx.tail; ++i) {
+        n += gc_shade(event_fx.event[i]);
+    }
+    return n;
 }
 
-static cell_t saved_q = { .head = NIL, .tail = NIL };
 static cell_t saved_a = { .head = UNDEF, .tail = UNDEF };
 
+int_t event_send(int_t event) {  // stage effect, or queue it directly
+    if (!event_txn) return event_q_put(event);
+    if (!IS_PAIR(event)) return FAIL;
+    if (event_fx.tail >= event_fx.size) {
+        event_buf_grow(&event_fx);
+    }
+    event_fx.event[event_fx.tail++] = event;
+    return OK;
+}
+
 int_t event_begin(int_t event) {
     XDEBUG(debug_print("event_begin event", event));
-    saved_q = event_q;  // snapshot event queue
+    event_fx.tail = 0;  // no pending effects
+    event_txn = 1;
     saved_a.head = UNDEF;  // prepare for BECOME
     saved_a.tail = UNDEF;
-    XDEBUG(hexdump("event_begin saved", PTR(&saved_q), 4));
     return event;
 }
 
@@ -699,20 +973,41 @@ int_t event_commit(int_t event) {
     XDEBUG(debug_print("event_commit target", target));
     if ((saved_a.head != UNDEF) && IS_ACTOR(target)) {
         cell_t *p = TO_PTR(target);
+        GC_BARRIER(saved_a.tail);
         *p = saved_a;  // update target actor
         XDEBUG(hexdump("event_commit become", PTR(p), 2));
     }
+    event_txn = 0;
+    for (nat_t i = 0; i < event_fx.tail; ++i) {
+        event_q_put(event_fx.event[i]);  // release pending SENDs
+    }
+    event_fx.tail = 0;
     return cell_free(event);
 }
 
 int_t event_rollback(int_t event) {
     XDEBUG(debug_print("event_rollback event", event));
-    event_q = saved_q;  // restore event queue (un-SEND)
+    event_txn = 0;
+    for (nat_t i = 0; i < event_fx.tail; ++i) {
+        cell_free(event_fx.event[i]);  // discard pending SENDs
+    }
+    event_fx.tail = 0;
     return cell_free(event);
 }
 
 i64 event_dispatch_count = 0;
+i64 event_dispatch_total = 0;  // never reset, see (bench)
 i64 event_dispatch_ticks = 0;
+i64 event_dispatch_worst = 0;
+
+#if TIME_DISPATCH
+static void event_dispatch_time(clock_t dt) {
+    event_dispatch_ticks += dt;
+    if (dt > event_dispatch_worst) {
+        event_dispatch_worst = dt;  // longest single dispatch
+    }
+}
+#endif
 
 int_t event_dispatch() {
 #if TIME_DISPATCH
@@ -740,6 +1035,7 @@ int_t event_dispatch() {
     } else {
         event = event_rollback(event);
     }
+    ++event_dispatch_total;
     // gather statistics
 #if TIME_DISPATCH
     clock_t t1 = clock();
@@ -747,30 +1043,45 @@ int_t event_dispatch() {
 #endif
 #if CONCURRENT_GC
 #if TIME_DISPATCH
-    event_dispatch_ticks += (t1 - t0);  // exclude gc
+    event_dispatch_time(t1 - t0);  // exclude gc
     DEBUG(double dt = (double)(t1 - t0) / CLOCKS_PER_SEC;
         printf("event_dispatch: t0=%ld t1=%ld dt=%.6f (%ld CPS)\n", t0, t1, dt, (long)CLOCKS_PER_SEC));
 #endif
-#else // !CONCURRENT_GC
-    if ((gc_free_cnt < 128) && (cell[0].head > (CELL_MAX - 256))) {
+#elif INCREMENT_GC
+    int work = gc_collect();
+    XDEBUG(printf("event_dispatch: gc visited %d cells\n", work));
+#if TIME_DISPATCH
+    if (work > 0) {
+        clock_t t2 = clock();
+        gc_ticks += (t2 - t1);
+        event_dispatch_time(t2 - t0);  // include gc
+    } else {
+        event_dispatch_time(t1 - t0);  // no gc step
+    }
+#endif
+#else // !CONCURRENT_GC && !INCREMENT_GC
+    if ((gc_free_cnt < INT(cell_max / 32)) && (NAT(cell[0].head) > (cell_max - (cell_max / 16)))) {
         int freed = gc_mark_and_sweep();
+        if (freed < INT(cell_max / 4)) {
+            cell_grow();  // avoid thrashing a nearly-full heap
+        }
         clock_t t2 = clock();
         DEBUG(printf("event_dispatch: gc reclaimed %d cells\n", freed));
 #if TIME_DISPATCH
-        event_dispatch_ticks += (t2 - t0);  // include gc
+        event_dispatch_time(t2 - t0);  // include gc
         DEBUG(double gc = (double)(t2 - t1) / CLOCKS_PER_SEC;
             printf("event_dispatch: t1=%ld t2=%ld gc=%.6f (%ld CPS)\n", t1, t2, gc, (long)CLOCKS_PER_SEC));
 #endif
     } else {
 #if TIME_DISPATCH
-        event_dispatch_ticks += (t1 - t0);  // exclude gc
+        event_dispatch_time(t1 - t0);  // exclude gc
 #endif
     }
 #if TIME_DISPATCH
     DEBUG(double dt = (double)(t1 - t0) / CLOCKS_PER_SEC;
         printf("event_dispatch: t0=%ld t1=%ld dt=%.6f (%ld CPS)\n", t0, t1, dt, (long)CLOCKS_PER_SEC));
 #endif
-#endif // CONCURRENT_GC
+#endif // CONCURRENT_GC || INCREMENT_GC
     return OK;
 }
 
@@ -782,6 +1093,7 @@ int_t event_loop() {
 #if TIME_DISPATCH
     event_dispatch_count = 0;
     event_dispatch_ticks = 0;
+    event_dispatch_worst = 0;
 #endif
     int_t result = OK;
     while (result == OK) {
@@ -789,8 +1101,8 @@ int_t event_loop() {
     }
 #if TIME_DISPATCH
     double average = ((double)event_dispatch_ticks / (double)event_dispatch_count);
-    printf("event_loop: count=%"PRId64" ticks=%"PRId64" average=%.3f\n",
-        event_dispatch_count, event_dispatch_ticks, average);
+    printf("event_loop: count=%"PRId64" ticks=%"PRId64" average=%.3f worst=%"PRId64"\n",
+        event_dispatch_count, event_dispatch_ticks, average, event_dispatch_worst);
 #endif
     return result;
 }
@@ -803,6 +1115,7 @@ int_t actor_create(int_t code, int_t data) {
     XDEBUG(debug_print("actor_create code", code));
     XDEBUG(debug_print("actor_create data", data));
     if (!IS_PROC(code)) return error("CREATE code must be a procedure");
+    GC_BARRIER(data);
     cell_t *p = cell_new();
     p->head = code;
     p->tail = data;
@@ -813,7 +1126,7 @@ int_t actor_send(int_t target, int_t msg) {
     XDEBUG(debug_print("actor_send target", target));
     XDEBUG(debug_print("actor_send msg", msg));
     int_t event = cons(target, msg);
-    return event_q_put(event);
+    return event_send(event);
 }
 
 int_t actor_become(int_t code, int_t data) {
@@ -974,8 +1287,7 @@ PROC_DECL(gc_sweep_beh);  // FORWARD DECLARATION
 PROC_DECL(gc_mark_beh) {
     XDEBUG(debug_print("gc_mark_beh self", self));
 
-    int_t root = event_q.head;  // everything is reachable from the event queue
-    if (root == NIL) {
+    if (event_q_len() == 0) {
         // if event queue is empty, stop concurrent gc
         DEBUG(printf("gc_mark_beh: STOP CONCURRENT GC\n"));
         return OK;
@@ -987,13 +1299,10 @@ PROC_DECL(gc_mark_beh) {
     int n = gc_mark_free();
     XDEBUG(printf("gc_mark_beh: marked %d free cells\n", n));
 
-#if GC_CALL_DEPTH
-    int m = gc_mark_cell(root, 0);
-#else
-    int m = gc_mark_cell(root);
-#endif
+    int m = gc_mark_roots();  // everything is reachable from the event queue
     XDEBUG(printf("gc_mark_beh: marked %d used cells\n", m));
 
+    GC_EVICT();
     gc_running = 1;  // enter unsafe gc phase
 
     BECOME(MK_PROC(gc_sweep_beh), UNDEF);
@@ -1024,7 +1333,7 @@ PROC_DECL(gc_mark_and_sweep_beh) {  // perform all GC steps together
     XDEBUG(debug_print("gc_mark_and_sweep_beh args", args));
     TAIL_ARG(count);
 
-    if (event_q.head == NIL) {
+    if (event_q_len() == 0) {
         // if event queue is empty, stop concurrent gc
         DEBUG(printf("gc_mark_and_sweep_beh: STOP CONCURRENT GC\n"));
         return OK;
@@ -1239,6 +1548,35 @@ int_t assoc_find(int_t assoc, int_t key) {
     }
     return UNDEF;  // not found
 }
+/*
+ * global bindings, indexed by symbol number (intern offset)
+ */
+
+const cell_t a_ground_env;  // FORWARD DECLARATION
+#define GROUND_ENV  MK_ACTOR(&a_ground_env)
+
+// WARNING! global_value[] must be part of the gc root set!
+static int_t global_value[INTERN_MAX];
+
+int_t global_lookup(int_t symbol) {  // value bound to `symbol`, or UNDEF
+    if (!is_symbol(symbol)) return UNDEF;
+    return global_value[TO_ENUM(symbol)];
+}
+int_t global_bind(int_t symbol, int_t value) {
+    if (!is_symbol(symbol)) return error("global symbol required");
+    GC_BARRIER(value);
+    return global_value[TO_ENUM(symbol)] = value;
+}
+i32 global_shade() {  // shade all global values, return count
+    i32 n = 0;
+    nat_t i = 0;
+    while (intern[i]) {
+        n += gc_shade(global_value[i]);
+        i += intern[i] + 1;
+    }
+    return n;
+}
+
 PROC_DECL(Scope) {
     XDEBUG(debug_print("Scope self", self));
     GET_VARS();  // (locals . penv)
@@ -1253,10 +1591,18 @@ PROC_DECL(Scope) {
         POP_ARG(symbol);
         END_ARGS();
         int_t binding = assoc_find(locals, symbol);
+        // resolve through enclosing scopes directly, rather than one event per level
+        while (!IS_PAIR(binding) && IS_ACTOR(penv) && (get_code(penv) == MK_PROC(Scope))) {
+            int_t data = get_data(penv);
+            binding = assoc_find(car(data), symbol);
+            penv = cdr(data);
+        }
         if (IS_PAIR(binding)) {
             int_t value = cdr(binding);
             DEBUG(debug_print("Scope value", value));
             SEND(cust, value); // send value to cust
+        } else if ((penv == GROUND_ENV) && (global_lookup(symbol) != UNDEF)) {
+            SEND(cust, global_lookup(symbol));  // short-cut to ground env
         } else if ((penv != NIL) && (penv != UNDEF)) {
             SEND(penv, arg);  // delegate to parent
         } else {
@@ -1287,6 +1633,7 @@ PROC_DECL(Scope) {
         // FIXME: surgically replace `locals` (WARNING! this is a non-transactional BECOME)
         XDEBUG(debug_print("Scope locals", locals));
         cell_t *p = TO_PTR(get_data(self));
+        GC_BARRIER(locals);
         p->head = locals;
         return OK;
     }
@@ -2436,6 +2783,38 @@ static PROC_DECL(prim_debug_print) {  // (debug-print object)
 const cell_t oper_debug_print = { .head = MK_PROC(Oper_prim), .tail = MK_PROC(prim_debug_print) };
 const cell_t a_debug_print = { .head = MK_PROC(Appl), .tail = MK_ACTOR(&oper_debug_print) };
 
+extern i64 event_dispatch_total;
+static PROC_DECL(prim_bench) {  // (bench workload)
+    static i64 prev_events = 0;
+    static clock_t prev_time = 0;
+    int_t opnd = self;
+    //int_t env = arg;
+    if (IS_PAIR(opnd)) {
+        int_t label = car(opnd);
+        opnd = cdr(opnd);
+        if (opnd == NIL) {
+            // report everything dispatched since the previous (bench)
+            clock_t now = clock();
+            i64 msgs = event_dispatch_total - prev_events;
+            i64 usecs = ((i64)(now - prev_time) * 1000000) / CLOCKS_PER_SEC;
+            printf("bench runtime=wart workload=");
+            print(label);
+            printf(" msgs=%"PRId64" usecs=%"PRId64" msgs_per_sec=%"PRId64
+                " ns_per_dispatch=%"PRId64" peak_heap=%"PRIuPTR"\n",
+                msgs, usecs, (usecs > 0) ? ((msgs * 1000000) / usecs) : 0,
+                (msgs > 0) ? ((usecs * 1000) / msgs) : 0,
+                NAT(cell[0].head) * sizeof(cell_t));  // high-water mark
+            fflush(stdout);
+            prev_events = event_dispatch_total;
+            prev_time = clock();
+            return UNIT;
+        }
+    }
+    return error("bench expected 1 argument");
+}
+const cell_t oper_bench = { .head = MK_PROC(Oper_prim), .tail = MK_PROC(prim_bench) };
+const cell_t a_bench = { .head = MK_PROC(Appl), .tail = MK_ACTOR(&oper_bench) };
+
 PROC_DECL(Fail) {
     WARN(debug_print("Fail self", self));
     GET_ARGS();
@@ -2443,9 +2822,6 @@ PROC_DECL(Fail) {
     return error("FAILED");
 }
 
-const cell_t a_ground_env;  // FORWARD DECLARATION
-#define GROUND_ENV  MK_ACTOR(&a_ground_env)
-
 #if META_ACTORS
 static PROC_DECL(fold_effect) {
     int_t zero = self;
@@ -2577,6 +2953,7 @@ static PROC_DECL(Actor_k_done) {
     }
     XDEBUG(debug_print("Actor_k_done meta-actor", actor));
     cell_t *p = TO_PTR(actor);
+    GC_BARRIER(beh);
     p->tail = beh;  // end event transaction
     SEND(cust, UNIT);
     return OK;
@@ -3245,6 +3622,84 @@ PROC_DECL(peg_label_beh) {
     return OK;
 }
 
+/*
+ * packrat memoization (opt-in, see `(memo <rule>)` in compile_peg_rule)
+ *
+ * results are cached per (ptrn, in), where `in` is the (token . next)
+ * pair at that input position (or NIL at the end). each result is either
+ * the (value . in) sent to `ok`, or FAIL. the memo table is not part of
+ * the gc root-set, so it is flushed whenever marking is complete.
+ */
+#define PEG_MEMO_MAX (1 << 10)  // direct-mapped entries (must be a power of 2)
+
+typedef struct peg_memo {
+    int_t       ptrn;           // memo actor (0 if empty)
+    int_t       in;             // input position
+    int_t       result;         // (value . in) -or- FAIL
+} peg_memo_t;
+
+static peg_memo_t peg_memo[PEG_MEMO_MAX];
+i64 peg_memo_hits = 0;
+i64 peg_memo_miss = 0;
+
+void peg_memo_clear() {
+    for (int i = 0; i < PEG_MEMO_MAX; ++i) {
+        peg_memo[i].ptrn = 0;
+    }
+}
+
+static peg_memo_t *peg_memo_slot(int_t ptrn, int_t in) {
+    nat_t h = (NAT(ptrn) >> 4) * 31 + (NAT(in) >> 4);
+    return &peg_memo[(h ^ (h >> 10)) & (PEG_MEMO_MAX - 1)];
+}
+
+static PROC_DECL(peg_memo_k_beh) {
+    PTRACE(debug_print("peg_memo_k_beh self", self));
+    GET_VARS();  // (cust success ptrn . in)
+    PTRACE(debug_print("peg_memo_k_beh vars", vars));
+    POP_VAR(cust);
+    POP_VAR(success);
+    POP_VAR(ptrn);
+    TAIL_VAR(in);
+    GET_ARGS();  // (value . in)
+    PTRACE(debug_print("peg_memo_k_beh args", args));
+    peg_memo_t *m = peg_memo_slot(ptrn, in);
+    m->ptrn = ptrn;  // record result (replacing any previous entry)
+    m->in = in;
+    m->result = ((success == TRUE) ? args : FAIL);
+    SEND(cust, args);
+    return OK;
+}
+PROC_DECL(peg_memo_beh) {
+    PTRACE(debug_print("peg_memo_beh self", self));
+    GET_VARS();  // ptrn
+    PTRACE(debug_print("peg_memo_beh vars", vars));
+    TAIL_VAR(ptrn);
+    GET_ARGS();  // (custs value . in) = ((ok . fail) value . (token . next))
+    PTRACE(debug_print("peg_memo_beh args", args));
+    POP_ARG(custs);  // (ok . fail)
+    int_t resume = args;  // (value . in)
+    int_t in = cdr(args);  // (token . next) -or- NIL
+    int_t ok = car(custs);
+    int_t fail = cdr(custs);
+    peg_memo_t *m = peg_memo_slot(self, in);
+    if ((m->ptrn == self) && (m->in == in)) {
+        ++peg_memo_hits;
+        if (m->result == FAIL) {
+            SEND(fail, resume);
+        } else {
+            SEND(ok, m->result);
+        }
+        return OK;
+    }
+    ++peg_memo_miss;
+    int_t key = cons(self, in);
+    int_t memo_ok = CREATE(MK_PROC(peg_memo_k_beh), cons(ok, cons(TRUE, key)));
+    int_t memo_fail = CREATE(MK_PROC(peg_memo_k_beh), cons(fail, cons(FALSE, key)));
+    SEND(ptrn, cons(cons(memo_ok, memo_fail), resume));
+    return OK;
+}
+
 PROC_DECL(peg_eval_beh) {
     XDEBUG(debug_print("peg_eval_beh self", self));
     GET_VARS();  // (ok . env)
@@ -3272,95 +3727,8 @@ PROC_DECL(Global) {
     if (req == s_lookup) {  // (cust 'lookup symbol)
         POP_ARG(symbol);
         END_ARGS();
-        int_t value = UNDEF;
-        int_t binding = UNDEF;//assoc_find(locals, symbol);
-        if (IS_PAIR(binding)) {
-            value = cdr(binding);
-        } else if (symbol == s_quote) {
-            value = MK_ACTOR(&a_quote);
-        } else if (symbol == s_list) {
-            value = MK_ACTOR(&a_list);
-        } else if (symbol == s_cons) {
-            value = MK_ACTOR(&a_cons);
-        } else if (symbol == s_car) {
-            value = MK_ACTOR(&a_car);
-        } else if (symbol == s_cdr) {
-            value = MK_ACTOR(&a_cdr);
-        } else if (symbol == s_if) {
-            value = MK_ACTOR(&a_if);
-        } else if (symbol == s_and) {
-            value = MK_ACTOR(&a_and);
-        } else if (symbol == s_or) {
-            value = MK_ACTOR(&a_or);
-        } else if (symbol == s_eqp) {
-            value = MK_ACTOR(&a_eqp);
-        } else if (symbol == s_equalp) {
-            value = MK_ACTOR(&a_equalp);
-        } else if (symbol == s_seq) {
-            value = MK_ACTOR(&a_seq);
-        } else if (symbol == s_lambda) {
-            value = MK_ACTOR(&a_lambda);
-        } else if (symbol == s_eval) {
-            value = MK_ACTOR(&a_eval);
-        } else if (symbol == s_apply) {
-            value = MK_ACTOR(&a_apply);
-        } else if (symbol == s_map) {
-            value = MK_ACTOR(&a_map);
-        } else if (symbol == s_macro) {
-            value = MK_ACTOR(&a_macro);
-        } else if (symbol == s_vau) {
-            value = MK_ACTOR(&a_vau);
-        } else if (symbol == s_define) {
-            value = MK_ACTOR(&a_define);
-        } else if (symbol == s_booleanp) {
-            value = MK_ACTOR(&a_booleanp);
-        } else if (symbol == s_nullp) {
-            value = MK_ACTOR(&a_nullp);
-        } else if (symbol == s_pairp) {
-            value = MK_ACTOR(&a_pairp);
-        } else if (symbol == s_symbolp) {
-            value = MK_ACTOR(&a_symbolp);
-        } else if (symbol == s_numberp) {
-            value = MK_ACTOR(&a_numberp);
-        } else if (symbol == s_add) {
-            value = MK_ACTOR(&a_add);
-        } else if (symbol == s_sub) {
-            value = MK_ACTOR(&a_sub);
-        } else if (symbol == s_mul) {
-            value = MK_ACTOR(&a_mul);
-        } else if (symbol == s_lt) {
-            value = MK_ACTOR(&a_lt);
-        } else if (symbol == s_le) {
-            value = MK_ACTOR(&a_le);
-        } else if (symbol == s_eqn) {
-            value = MK_ACTOR(&a_eqn);
-        } else if (symbol == s_ge) {
-            value = MK_ACTOR(&a_ge);
-        } else if (symbol == s_gt) {
-            value = MK_ACTOR(&a_gt);
-        } else if (symbol == s_list_to_number) {
-            value = MK_ACTOR(&a_list_to_number);
-        } else if (symbol == s_list_to_symbol) {
-            value = MK_ACTOR(&a_list_to_symbol);
-        } else if (symbol == s_print) {
-            value = MK_ACTOR(&a_print);
-        } else if (symbol == s_emit) {
-            value = MK_ACTOR(&a_emit);
-        } else if (symbol == s_debug_print) {
-            value = MK_ACTOR(&a_debug_print);
-#if META_ACTORS
-        } else if (symbol == s_BEH) {
-            value = MK_ACTOR(&a_BEH);
-        } else if (symbol == s_CREATE) {
-            value = MK_ACTOR(&a_CREATE);
-        } else if (symbol == s_SEND) {
-            value = MK_ACTOR(&a_SEND);
-        } else if (symbol == s_BECOME) {
-            value = MK_ACTOR(&a_BECOME);
-        } else if (symbol == s_FAIL) {
-            value = MK_ACTOR(&a_FAIL);
-#endif
-        } else {
+        int_t value = global_lookup(symbol);
+        if (value == UNDEF) {
             WARN(debug_print("Global lookup failed", symbol));
             value = error("undefined variable");
         }
@@ -3368,12 +3736,76 @@ PROC_DECL(Global) {
         SEND(cust, value);
         return OK;
     }
+    if (req == s_bind) {  // (cust 'bind assoc)
+        POP_ARG(assoc);
+        XDEBUG(debug_print("Global assoc", assoc));
+        END_ARGS();
+        while (IS_PAIR(assoc)) {
+            int_t binding = car(assoc);
+            if (IS_PAIR(binding)) {
+                global_bind(car(binding), cdr(binding));  // update in-place
+            }
+            assoc = cdr(assoc);
+        }
+        SEND(cust, UNIT);
+        return OK;
+    }
     return SeType(self, arg);  // delegate to SeType
 }
-// WARNING! gnd_locals.head must be part of the gc root set!
-const cell_t a_global_env = { .head = MK_PROC(Global), .tail = UNDEF };
-static cell_t gnd_locals = { .head = NIL, .tail = MK_ACTOR(&a_global_env) };
-const cell_t a_ground_env = { .head = MK_PROC(Scope), .tail = MK_PAIR(&gnd_locals) };
+const cell_t a_ground_env = { .head = MK_PROC(Global), .tail = UNDEF };
+
+// runtime initialization
+int_t global_boot() {
+    nat_t i;
+    for (i = 0; i < INTERN_MAX; ++i) {
+        global_value[i] = UNDEF;
+    }
+    global_bind(s_quote, MK_ACTOR(&a_quote));
+    global_bind(s_list, MK_ACTOR(&a_list));
+    global_bind(s_cons, MK_ACTOR(&a_cons));
+    global_bind(s_car, MK_ACTOR(&a_car));
+    global_bind(s_cdr, MK_ACTOR(&a_cdr));
+    global_bind(s_if, MK_ACTOR(&a_if));
+    global_bind(s_and, MK_ACTOR(&a_and));
+    global_bind(s_or, MK_ACTOR(&a_or));
+    global_bind(s_eqp, MK_ACTOR(&a_eqp));
+    global_bind(s_equalp, MK_ACTOR(&a_equalp));
+    global_bind(s_seq, MK_ACTOR(&a_seq));
+    global_bind(s_lambda, MK_ACTOR(&a_lambda));
+    global_bind(s_eval, MK_ACTOR(&a_eval));
+    global_bind(s_apply, MK_ACTOR(&a_apply));
+    global_bind(s_map, MK_ACTOR(&a_map));
+    global_bind(s_macro, MK_ACTOR(&a_macro));
+    global_bind(s_vau, MK_ACTOR(&a_vau));
+    global_bind(s_define, MK_ACTOR(&a_define));
+    global_bind(s_booleanp, MK_ACTOR(&a_booleanp));
+    global_bind(s_nullp, MK_ACTOR(&a_nullp));
+    global_bind(s_pairp, MK_ACTOR(&a_pairp));
+    global_bind(s_symbolp, MK_ACTOR(&a_symbolp));
+    global_bind(s_numberp, MK_ACTOR(&a_numberp));
+    global_bind(s_add, MK_ACTOR(&a_add));
+    global_bind(s_sub, MK_ACTOR(&a_sub));
+    global_bind(s_mul, MK_ACTOR(&a_mul));
+    global_bind(s_lt, MK_ACTOR(&a_lt));
+    global_bind(s_le, MK_ACTOR(&a_le));
+    global_bind(s_eqn, MK_ACTOR(&a_eqn));
+    global_bind(s_ge, MK_ACTOR(&a_ge));
+    global_bind(s_gt, MK_ACTOR(&a_gt));
+    global_bind(s_list_to_number, MK_ACTOR(&a_list_to_number));
+    global_bind(s_list_to_symbol, MK_ACTOR(&a_list_to_symbol));
+    global_bind(s_print, MK_ACTOR(&a_print));
+    global_bind(s_emit, MK_ACTOR(&a_emit));
+    global_bind(s_debug_print, MK_ACTOR(&a_debug_print));
+    global_bind(s_bench, MK_ACTOR(&a_bench));
+#if META_ACTORS
+    global_bind(s_BEH, MK_ACTOR(&a_BEH));
+    global_bind(s_CREATE, MK_ACTOR(&a_CREATE));
+    global_bind(s_SEND, MK_ACTOR(&a_SEND));
+    global_bind(s_BECOME, MK_ACTOR(&a_BECOME));
+    global_bind(s_FAIL, MK_ACTOR(&a_FAIL));
+#endif
+    return OK;
+}
 
 /*
  * display procedures
@@ -3811,6 +4243,10 @@ int_t compile_peg_rule(int_t scope, int_t rule) {
             ptrn = compile_peg_rule(scope, car(rule));
             if (ptrn == UNDEF) return UNDEF;
             ptrn = CREATE(MK_PROC(peg_plus_beh), ptrn);
+        } else if (kind == symbol("memo")) {
+            ptrn = compile_peg_rule(scope, car(rule));
+            if (ptrn == UNDEF) return UNDEF;
+            ptrn = CREATE(MK_PROC(peg_memo_beh), ptrn);
         } else if (kind == symbol("class")) {
             int_t class = 0;
             while (IS_PAIR(rule)) {
@@ -4195,6 +4631,30 @@ int_t test_parsing() {
     SEND(src, start);
     event_loop();
 
+    /*
+     * packrat memoization
+     *  term   = num '+' num | num '-' num | num
+     *  num    = memo([0-9]+)
+     *
+     * test-case "12-345\n"
+     */
+    char nstr_buf4[] = { 7, 49, 50, 45, 51, 52, 53, 10 };
+    ASSERT(nstr_init(&str_in, nstr_buf4) == 0);
+    src = CREATE(MK_PROC(input_promise_beh), MK_ACTOR(&str_in));
+    scope = CREATE(MK_PROC(Scope), cons(NIL, NIL));  // empty env, no parent
+    ASSERT(add_peg_rule(scope, "term",
+        "(alt (seq num (eq 43) num) (seq num (eq 45) num) num)") == OK);
+    ASSERT(add_peg_rule(scope, "num",
+        "(memo (plus (class DGT)))") == OK);
+    ptrn = cdr(assoc_find(car(get_data(scope)), symbol("term")));
+    i64 hits = peg_memo_hits;
+    ok = CREATE(MK_PROC(peg_result_beh), symbol("ok"));
+    fail = CREATE(MK_PROC(peg_result_beh), symbol("fail"));
+    start = CREATE(MK_PROC(peg_start_beh), cons(cons(ok, fail), ptrn));
+    SEND(src, start);
+    event_loop();
+    ASSERT(peg_memo_hits > hits);  // 2nd alternative re-used 1st `num`
+
     return OK;
 }
 #endif // PEG_ACTORS
@@ -4506,6 +4966,7 @@ int_t unit_tests() {
 
 int_t actor_boot() {
     ASSERT(symbol_boot() == OK);
+    ASSERT(global_boot() == OK);
     return OK;
 }
 
@@ -4537,6 +4998,13 @@ int main(int argc, char const *argv[])
 {
     int_t result = OK;
 
+    nat_t heap_limit = CELL_LIMIT;
+    int first_file = 1;
+    if ((argc > 2) && (strcmp(argv[1], "-m") == 0)) {  // -m <max-cells>
+        heap_limit = strtoul(argv[2], NULL, 0);
+        first_file = 3;
+    }
+    ASSERT(heap_init(heap_limit) == OK);
     ASSERT(actor_boot() == OK);
 
 #if RUN_SELF_TEST
@@ -4562,7 +5030,7 @@ int main(int argc, char const *argv[])
     ASSERT(IS_PROC(get_code(UNIT)));
 
     fprintf(stderr, "   cell = %"PRIxPTR"x%"PRIxPTR"\n",
-        INT(cell), NAT(sizeof(cell)));
+        INT(cell), NAT(cell_limit * sizeof(cell_t)));
     fprintf(stderr, " intern = %"PRIxPTR"x%"PRIxPTR"\n",
         INT(intern), NAT(sizeof(intern)));
     //ASSERT((NAT(cell) & 0x7) == 0x0);
@@ -4588,7 +5056,7 @@ int main(int argc, char const *argv[])
 #if RUN_FILE_REPL
     WARN(fprintf(stderr, "--load_file--\n"));
     printf("argc = %d\n", argc);
-    for (int i = 1; i < argc; ++i) {
+    for (int i = first_file; i < argc; ++i) {
         printf("argv[%d] = %s\n", i, argv[i]);
         FILE *f = fopen(argv[i], "r");
         if (f) {
@@ -5,11 +5,13 @@
 #include "timer.h"
 #include "serial.h"
 
-#define SOH (0x01)  // Start of Header
+#define SOH (0x01)  // Start of Header (128-byte block)
+#define STX (0x02)  // Start of Text (1024-byte block)
 #define ACK (0x06)  // Acknowledge
 #define NAK (0x15)  // Negative Ack
 #define EOT (0x04)  // End of Transmission
 #define CAN (0x18)  // Cancel
+#define CRC (0x43)  // 'C' requests CRC-16 mode
 
 int
 rcv_timeout(int timeout)
@@ -30,7 +32,7 @@ rcv_timeout(int timeout)
     }
 }
 
-#define CHAR_TIME   (250 msecs)  // wait 0.25 seconds per character
+#define CHAR_TIME   (100 msecs)  // wait 0.1 seconds per character
 
 void
 rcv_flush()
@@ -39,94 +41,171 @@ rcv_flush()
         ;
 }
 
+/*
+ * CRC-16/XMODEM (polynomial 0x1021), one nibble at a time
+ */
+static const u16 crc_nibble[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+static u32
+crc_update(u32 crc, u32 data)
+{
+    crc = (crc << 4) ^ crc_nibble[((crc >> 12) ^ (data >> 4)) & 0x0F];
+    crc = (crc << 4) ^ crc_nibble[((crc >> 12) ^ data) & 0x0F];
+    return crc & 0xFFFF;
+}
+
+/*
+ * Receive XMODEM (128-byte checksum, CRC-16 or 1K) blocks into sink
+ *
+ * Each good block is acknowledged before it is passed to the sink,
+ * so the sender transmits the next block (into the serial rx ring)
+ * while the sink processes the current one.
+ */
 int
-rcv_xmodem(u8* buf, int limit)
+rcv_xmodem_stream(xmodem_sink sink, void* ctx)
 {
+    static u8 block[1024];
     int data;
-    int rem;
-    int len = 0;
+    int num;
+    int n;
+    int i;
     int chk;
+    int len = 0;
     int blk = 0;
     int try = 0;
-    int ok = NAK;
+    int crc = 1;  // start in CRC-16 mode
+    int reply = CRC;
 
-    limit -= 128;
-    while (len <= limit) {  // make sure there is room to receive block
-        if (ok == ACK) {
-            try = 0;  // reset retry counter
-        } else {
-            rcv_flush();  // clear input
-        }
+    for (;;) {
         if (++try > 10) {  // retry 10 times on all errors
             break;  // FAIL!
         }
-        serial_write(ok);
-        ok = NAK;
+        if ((blk == 0) && crc && (try > 3)) {  // sender ignores 'C'
+            crc = 0;  // fall back to checksum mode
+            reply = NAK;
+        }
+        if (reply) {
+            serial_write(reply);
+        }
+        reply = ((blk == 0) && crc) ? CRC : NAK;
 
-        /* receive start-of-header (SOH) */
-        data = rcv_timeout(3 secs);  // send NAK every 3 seconds 
+        /* receive start-of-header (SOH/STX) */
+        data = rcv_timeout(3 secs);  // send NAK every 3 seconds
         if (data < 0) {
-            continue;  // retry
+            continue;  // retry, line is already quiet
         } else if (data == EOT) {  // end-of-transmission
             serial_write(ACK);
-            return len;  // SUCCESS! return total length of data in buffer
-        } else if (data != SOH) {  // start-of-header
+            return len;  // SUCCESS! return total length of data received
+        } else if (data == CAN) {  // cancelled by sender
+            return -1;  // FAIL!
+        } else if (data == SOH) {
+            n = 128;
+        } else if (data == STX) {
+            n = 1024;
+        } else {
+            rcv_flush();  // resynchronize
             continue;  // reject
         }
 
-        /* receive block number */
-        data = rcv_timeout(CHAR_TIME);
-        if (data < 0) {
+        /* receive block number and its inverse */
+        num = rcv_timeout(CHAR_TIME);
+        chk = rcv_timeout(CHAR_TIME);
+        if ((num < 0) || (chk < 0)) {
             continue;  // reject
         }
-        if (data == (blk & 0xFF)) {  // previous block #
-            rcv_flush();  // ignore duplicate block
-            ok = ACK;  // acknowledge block
-            continue;
-        }
-        if (data != ((blk + 1) & 0xFF)) {  // unexpected block
-            rcv_flush();  // ignore unexpected block
-            break;  // FAIL!
+        if (num != (~chk & 0xFF)) {  // block # mismatch
+            rcv_flush();  // resynchronize
+            continue;  // reject
         }
 
-        /* receive inverse block number */
-        data = rcv_timeout(CHAR_TIME);
-        if (data < 0) {
-            continue;  // reject
+        /* receive block data */
+        chk = 0;  // checksum or crc
+        for (i = 0; i < n; ++i) {
+            if ((data = rcv_timeout(CHAR_TIME)) < 0) {
+                break;  // timeout
+            }
+            block[i] = data;
+            chk = crc ? crc_update(chk, data) : (chk + data);
         }
-        if (data != (~(blk + 1) & 0xFF)) {  // block # mismatch
+        if (i < n) {  // incomplete block
             continue;  // reject
         }
 
-        /* receive block data (128 bytes) */
-        chk = 0;  // checksum
-        rem = 128;  // remaining count
-        do {
-            data = rcv_timeout(CHAR_TIME);
-            if (data < 0) {
-                break;  // timeout
+        /* receive crc or checksum */
+        if (crc) {
+            i = rcv_timeout(CHAR_TIME) << 8;
+            i |= rcv_timeout(CHAR_TIME);
+            if ((i < 0) || (i != chk)) {  // bad crc
+                continue;  // reject
+            }
+        } else {
+            i = rcv_timeout(CHAR_TIME);
+            if ((i < 0) || (i != (chk & 0xFF))) {  // bad checksum
+                continue;  // reject
             }
-            buf[len++] = data;  // store data in buffer
-            chk += data;  // accumulate checksum
-        } while (--rem > 0);
-        if (rem > 0) {  // incomplete block
-            len -= (128 - rem);  // ignore partial block data
-            continue;  // reject
         }
 
-        /* receive checksum */
-        data = rcv_timeout(CHAR_TIME);
-        if ((data < 0) || (data != (chk & 0xFF))) {  // bad checksum
-            len -= 128;  // ignore bad block data
-            continue;  // reject
+        /* check block sequence */
+        try = 0;  // reset retry counter
+        if (num == (blk & 0xFF)) {  // previous block #
+            reply = ACK;  // acknowledge duplicate block
+            continue;
+        }
+        if (num != ((blk + 1) & 0xFF)) {  // unexpected block
+            break;  // FAIL!
         }
 
-        /* acknowledge good block */
-        ok = ACK;
+        /* acknowledge good block, then let the sink consume it */
+        serial_write(ACK);
+        reply = 0;  // wait for next block
         ++blk;  // update expected block #
+        if (sink(ctx, block, n) < 0) {
+            break;  // FAIL!
+        }
+        len += n;
     }
     serial_write(CAN);  // I tell you three times...
     serial_write(CAN);
     serial_write(CAN);
-    return 0;  // FAIL!
+    return -1;  // FAIL!
+}
+
+struct xmodem_mem {
+    u8*         buf;
+    int         len;
+    int         limit;
+};
+
+static int
+mem_sink(void* ctx, const u8* data, int n)
+{
+    struct xmodem_mem* mem = ctx;
+    u8* p;
+
+    if ((mem->len + n) > mem->limit) {
+        return -1;  // buffer full
+    }
+    p = mem->buf + mem->len;
+    mem->len += n;
+    while (n-- > 0) {
+        *p++ = *data++;
+    }
+    return 0;
+}
+
+/*
+ * Receive XMODEM transfer into buffer, limited by size
+ */
+int
+rcv_xmodem(u8* buf, int limit)
+{
+    struct xmodem_mem mem;
+
+    mem.buf = buf;
+    mem.len = 0;
+    mem.limit = limit;
+    return rcv_xmodem_stream(mem_sink, &mem);
 }
@@ -20,6 +20,9 @@
 
 #include "raspi.h"
 
+typedef int (*xmodem_sink)(void* ctx, const u8* data, int n);  /* < 0 to abort */
+
 extern int      rcv_xmodem(u8* buf, int size);  /* receive into buffer, limited by size */
+extern int      rcv_xmodem_stream(xmodem_sink sink, void* ctx);  /* pass blocks to sink */
 
 #endif /* _XMODEM_H_ */